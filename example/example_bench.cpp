@@ -0,0 +1,420 @@
+/// \file       example_bench.cpp
+/// \brief      This example measures parser throughput over synthetic OEM7 traffic by Win32, POSIX or ESP32
+/// \details    Frames of every supported log with correct CRCs, then the same stream with corrupted frames,
+/// \details    junk with false sync bytes, cut frames and oversize headers. Reports MB/s and frames/s of
+/// \details    \c read(), \c read() + \c cache() (what \c update() does per frame) and \c update(), and CRC time.
+/// \details    On ESP32 also CPU cycles per frame by \c ESP.getCycleCount(). With an argument on Win32 or POSIX
+/// \details    the second stream is a capture or raw binary log file instead. On Win32 and POSIX two receivers then parse
+/// \details    the synthetic streams in parallel threads and must give the counters and solution of a single-threaded run
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Receiver.h"
+#include "Crc32.h"
+#include "Log.h"
+
+#include <string.h>
+#if defined(ESP32)
+# define BENCH_BYTES 32768
+# define BENCH_PASSES 32
+# define BENCH_CHUNK 256
+# define PRINT(...) Serial.printf(__VA_ARGS__)
+#else
+# include <cstdio>
+# include <chrono>
+# include <thread>
+# include <vector>
+# define BENCH_BYTES (4 * 1024 * 1024)
+# define BENCH_PASSES 8
+# define BENCH_CHUNK 1024
+# define PRINT(...) printf(__VA_ARGS__)
+#endif
+
+namespace {
+	uint8_t stream[BENCH_BYTES];
+
+	/// \brief Benchmark clock: microseconds and, on ESP32, CPU cycles
+	struct Clock {
+#if defined(ESP32)
+		uint32_t cycles{ ESP.getCycleCount() };
+		uint32_t us{ static_cast<uint32_t>(micros()) };
+		uint32_t elapsedCycles() const { return ESP.getCycleCount() - cycles; }
+		double elapsed() const { return static_cast<uint32_t>(micros()) - us; }
+#else
+		std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+		uint32_t elapsedCycles() const { return 0; }
+		double elapsed() const { return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count(); }
+#endif
+	};
+
+	/// \brief Pseudo-random numbers: same stream on every run
+	struct Random {
+		uint32_t state{ 0x2545F491 };
+		uint32_t next()
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+	};
+
+	/// \brief Append frame
+	/// \return Frame size or 0 if it does not fit
+	size_t frame(uint8_t* out, const size_t room, const uint16_t msgId, const void* body, const uint16_t size, const uint16_t week, const uint32_t ms)
+	{
+		const size_t total = oem7::HEAD_LENGHT + size + sizeof(uint32_t);
+		if (total > room) return 0;
+		oem7::Head head;
+		memset(&head, 0, sizeof(head));
+		head.msgId = msgId;
+		head.msgLenght = size;
+		head.idleTime = 150;
+		head.timeStatus = oem7::GPSTIME_FINESTEERING;
+		head.week = week;
+		head.ms = ms;
+		head.receiverVersion = 16000;
+		out[0] = oem7::HEAD_SYNC_1;
+		out[1] = oem7::HEAD_SYNC_2;
+		out[2] = oem7::HEAD_SYNC_3;
+		out[3] = oem7::HEAD_LENGHT;
+		memcpy(&out[4], &head, sizeof(head));
+		memcpy(&out[oem7::HEAD_LENGHT], body, size);
+		const uint32_t crc = oem7::Crc32::compute(out, oem7::HEAD_LENGHT + size);
+		memcpy(&out[oem7::HEAD_LENGHT + size], &crc, sizeof(crc));
+		return total;
+	}
+
+	/// \brief Fill stream with logs of all supported messages
+	/// \param corrupt Per mille of damaged frames
+	/// \param frames Number of intact frames
+	/// \return Stream size
+	size_t generate(const unsigned corrupt, uint32_t& frames)
+	{
+		Random random;
+		uint8_t body[512];
+		size_t used = 0;
+		uint32_t ms = 0;
+		frames = 0;
+		for (uint32_t i = 0; ; ++i) {
+			uint16_t msgId = 0;
+			uint16_t size = 0;
+			memset(body, 0, sizeof(body));
+			switch (i % 8) {
+			case 0:
+			case 4: {
+				oem7::BestPos pos;
+				memset(&pos, 0, sizeof(pos));
+				pos.positionType = oem7::POS_NARROW_INT;
+				pos.lat = 50.45 + (random.next() % 1000) * 1e-9;
+				pos.lon = 30.52;
+				pos.alt = 180.0;
+				pos.latStdDev = pos.lonStdDev = pos.altStdDev = 0.02f;
+				memcpy(body, &pos, sizeof(pos));
+				msgId = oem7::MSG_BESTPOS;
+				size = sizeof(pos);
+				ms += 125;
+				break;
+			}
+			case 1:
+			case 5: {
+				oem7::DualAntHeading hdg;
+				memset(&hdg, 0, sizeof(hdg));
+				hdg.positionType = oem7::POS_NARROW_INT;
+				hdg.heading = static_cast<float>(random.next() % 36000) * 0.01f;
+				hdg.hdgStdDev = 0.1f;
+				hdg.length = 1.5f;
+				memcpy(body, &hdg, sizeof(hdg));
+				msgId = oem7::MSG_DUALANTHEADING;
+				size = sizeof(hdg);
+				break;
+			}
+			case 2: {
+				oem7::Heading2 hdg;
+				memset(&hdg, 0, sizeof(hdg));
+				hdg.positionType = oem7::POS_NARROW_INT;
+				memcpy(hdg.roverID, (i & 8) ? "RVR1" : "RVR2", sizeof(hdg.roverID));
+				memcpy(body, &hdg, sizeof(hdg));
+				msgId = oem7::MSG_HEADING2;
+				size = sizeof(hdg);
+				break;
+			}
+			case 3: {
+				oem7::Time time;
+				memset(&time, 0, sizeof(time));
+				time.clock_status = oem7::CLOCK_VALID;
+				time.utc_status = oem7::UTC_VALID;
+				time.utc_year = 2024;
+				time.utc_month = 6;
+				time.utc_day = 1;
+				memcpy(body, &time, sizeof(time));
+				msgId = oem7::MSG_TIME;
+				size = sizeof(time);
+				break;
+			}
+			case 6: {
+				oem7::RxStatus status;
+				memset(&status, 0, sizeof(status));
+				memcpy(body, &status, sizeof(status));
+				msgId = oem7::MSG_RXSTATUS;
+				size = sizeof(status);
+				break;
+			}
+			default: {
+				// HWMONITOR and VERSION in turn: variable length
+				const uint32_t count = (i & 8) ? 2 : 5;
+				memcpy(body, &count, sizeof(count));
+				if (i & 8) {
+					oem7::Version version[2];
+					memset(version, 0, sizeof(version));
+					strcpy(version[0].model, "FDNRNNTBN");
+					memcpy(&body[sizeof(count)], version, sizeof(version));
+					msgId = oem7::MSG_VERSION;
+					size = sizeof(count) + sizeof(version);
+				} else {
+					oem7::HWMonitor monitor[5];
+					memset(monitor, 0, sizeof(monitor));
+					for (uint32_t k = 0; k < count; ++k) {
+						monitor[k].type = static_cast<uint8_t>(oem7::HW_TEMPERATURE1 + k);
+						monitor[k].value = 3.3f;
+					}
+					memcpy(&body[sizeof(count)], monitor, sizeof(monitor));
+					msgId = oem7::MSG_HWMONITOR;
+					size = sizeof(count) + sizeof(monitor);
+				}
+				break;
+			}
+			}
+			uint8_t* out = &stream[used];
+			const size_t n = frame(out, sizeof(stream) - used, msgId, body, size, 2300, ms);
+			if (n == 0) break;
+			used += n;
+			if (corrupt == 0 || random.next() % 1000 >= corrupt) {
+				++frames;
+				continue;
+			}
+			switch (random.next() % 4) {
+			case 0:
+				// CRC failure
+				out[oem7::HEAD_LENGHT + random.next() % size] ^= 0x5A;
+				break;
+			case 1:
+				// Frame cut: the next one follows at once
+				used -= n / 2;
+				break;
+			case 2:
+				// Oversize header: the framer resyncs inside it
+				out[8] = 0xFF;
+				out[9] = 0x7F;
+				break;
+			default: {
+				// Junk with false sync bytes after an intact frame
+				++frames;
+				for (size_t k = 0; k < 64 && used < sizeof(stream); ++k) {
+					stream[used++] = static_cast<uint8_t>(k % 16 == 0 ? static_cast<uint32_t>(oem7::HEAD_SYNC_1) :
+						k % 16 == 1 ? static_cast<uint32_t>(oem7::HEAD_SYNC_2) : random.next());
+				}
+				break;
+			}
+			}
+		}
+		return used;
+	}
+
+	/// \brief Print throughput
+	void report(const char* name, const size_t bytes, const uint32_t frames, const double us, const uint32_t cycles)
+	{
+		PRINT("  %-14s %8.1f MB/s", name, bytes / us);
+		if (frames != 0) PRINT(" %9.0f frames/s", frames * 1e6 / us);
+		if (cycles != 0 && frames != 0) PRINT(" %7.0f cycles/frame %5.1f cycles/byte", static_cast<double>(cycles) / frames, static_cast<double>(cycles) / bytes);
+		PRINT("\n");
+	}
+
+	void discard(const uint8_t level, const char* text, void* context)
+	{
+		(void)level;
+		(void)text;
+		(void)context;
+	}
+
+	/// \brief Measure one stream
+	void bench(const char* title, const size_t size, const uint32_t intact)
+	{
+		PRINT("%s: %u bytes, %u intact frames\n", title, static_cast<unsigned>(size), static_cast<unsigned>(intact));
+		const size_t bytes = size * BENCH_PASSES;
+		// Fresh parser and statistics for each stream
+		oem7::MemoryTransport memory;
+		oem7::BasicReceiver<oem7::MemoryTransport>* receiver = new oem7::BasicReceiver<oem7::MemoryTransport>(memory);
+		oem7::BasicReceiver<oem7::MemoryTransport>& gnss = *receiver;
+		oem7::Frame frame;
+		// CRC alone over the whole stream
+		uint32_t crc = 0;
+		Clock clock;
+		for (int pass = 0; pass < BENCH_PASSES; ++pass) crc += oem7::Crc32::compute(stream, size);
+		const double crcTime = clock.elapsed();
+		report("crc", bytes, 0, crcTime, 0);
+		// Framing, CRC, handlers and latest solution
+		uint32_t frames = 0;
+		clock = Clock();
+		for (int pass = 0; pass < BENCH_PASSES; ++pass) {
+			memory.assign(stream, size);
+			for (;;) {
+				if (gnss.read(frame)) ++frames;
+				else if (memory.atEnd()) break;
+			}
+		}
+		const double readTime = clock.elapsed();
+		report("read", bytes, frames, readTime, clock.elapsedCycles());
+		// Per frame work of update(): read and copy into the snapshot
+		frames = 0;
+		clock = Clock();
+		for (int pass = 0; pass < BENCH_PASSES; ++pass) {
+			memory.assign(stream, size);
+			for (;;) {
+				if (gnss.read(frame)) {
+					gnss.cache(frame);
+					++frames;
+				} else if (memory.atEnd()) break;
+			}
+		}
+		report("read+cache", bytes, frames, clock.elapsed(), clock.elapsedCycles());
+		// update(): epochs, status, validation and log output, per serial burst of BENCH_CHUNK bytes until it is parsed
+		const uint32_t parsed = gnss.stats().frames;
+		clock = Clock();
+		for (int pass = 0; pass < BENCH_PASSES; ++pass) {
+			for (size_t used = 0; used < size; used += BENCH_CHUNK) {
+				memory.assign(&stream[used], size - used < BENCH_CHUNK ? size - used : BENCH_CHUNK);
+				do {
+					gnss.update();
+				} while (!memory.atEnd());
+			}
+		}
+		const double updateTime = clock.elapsed();
+		const uint32_t updateCycles = clock.elapsedCycles();
+		report("update", bytes, gnss.stats().frames - parsed, updateTime, updateCycles);
+		const oem7::ReceiverStats stats = gnss.stats();
+		PRINT("  crc share of read %.0f%%, update of %u bytes: mean %u us p99 %u us max %u us\n",
+			readTime > 0 ? 100.0 * crcTime / readTime : 0.0, static_cast<unsigned>(BENCH_CHUNK),
+			static_cast<unsigned>(stats.update.mean()), static_cast<unsigned>(stats.update.quantile(0.99)), static_cast<unsigned>(stats.update.max));
+		PRINT("  parser totals: frames %u, crc errors %u, oversize %u, discarded %u bytes (crc %08X)\n",
+			static_cast<unsigned>(stats.frames), static_cast<unsigned>(stats.crc), static_cast<unsigned>(stats.oversize),
+			static_cast<unsigned>(stats.discarded), static_cast<unsigned>(crc));
+		delete receiver;
+	}
+
+#if !defined(ESP32)
+	/// \brief Parse results compared between runs: counters and latest solution, without host receive times
+	struct Outcome {
+		oem7::ReceiverStats stats;
+		oem7::Solution latest;
+	};
+
+	/// \brief Parse a whole stream by update() in bursts of BENCH_CHUNK bytes
+	Outcome parse(const std::vector<uint8_t>& data)
+	{
+		oem7::MemoryTransport memory;
+		oem7::BasicReceiver<oem7::MemoryTransport>* receiver = new oem7::BasicReceiver<oem7::MemoryTransport>(memory);
+		for (size_t used = 0; used < data.size(); used += BENCH_CHUNK) {
+			memory.assign(&data[used], data.size() - used < BENCH_CHUNK ? data.size() - used : BENCH_CHUNK);
+			do {
+				receiver->update();
+			} while (!memory.atEnd());
+		}
+		Outcome result;
+		result.stats = receiver->stats();
+		result.latest = receiver->latest();
+		delete receiver;
+		return result;
+	}
+
+	bool same(const Outcome& a, const Outcome& b)
+	{
+		const oem7::ReceiverStats& x = a.stats;
+		const oem7::ReceiverStats& y = b.stats;
+		if (x.frames != y.frames || x.crc != y.crc || x.headSize != y.headSize || x.oversize != y.oversize ||
+			x.discarded != y.discarded || x.other != y.other) return false;
+		for (size_t i = 0; i < OEM7_STATS_MESSAGES; ++i) {
+			const oem7::MessageStats& m = x.messages[i];
+			const oem7::MessageStats& n = y.messages[i];
+			if (m.msgId != n.msgId || m.received != n.received || m.crc != n.crc || m.size != n.size) return false;
+		}
+		const oem7::Solution& p = a.latest;
+		const oem7::Solution& q = b.latest;
+		return p.positionWeek == q.positionWeek && p.positionMs == q.positionMs && p.headingWeek == q.headingWeek &&
+			p.headingMs == q.headingMs && p.lat == q.lat && p.lon == q.lon && p.alt == q.alt && p.heading == q.heading &&
+			p.pitch == q.pitch && p.positionValid == q.positionValid && p.headingValid == q.headingValid && p.valid == q.valid;
+	}
+
+	/// \brief Two receivers updated in parallel threads give the results of a single-threaded run
+	/// \return Results match
+	bool parallel()
+	{
+		uint32_t intact = 0;
+		const std::vector<uint8_t> clean(stream, stream + generate(0, intact));
+		const std::vector<uint8_t> corrupted(stream, stream + generate(20, intact));
+		const Outcome first = parse(clean);
+		const Outcome second = parse(corrupted);
+		Outcome parallelFirst;
+		Outcome parallelSecond;
+		std::thread a([&]() { parallelFirst = parse(clean); });
+		std::thread b([&]() { parallelSecond = parse(corrupted); });
+		a.join();
+		b.join();
+		const bool ok = same(first, parallelFirst) && same(second, parallelSecond) && first.stats.frames != 0 && second.stats.frames != 0;
+		PRINT("parallel receivers: frames %u and %u, %s\n", static_cast<unsigned>(parallelFirst.stats.frames),
+			static_cast<unsigned>(parallelSecond.stats.frames), ok ? "same as single-threaded" : "MISMATCH");
+		return ok;
+	}
+#endif
+
+	void run(const char* path)
+	{
+		oem7::Log::setSink(&discard);
+		uint32_t intact = 0;
+		size_t size = generate(0, intact);
+		bench("clean", size, intact);
+#if !defined(ESP32)
+		if (path != nullptr) {
+			// Captured traffic: a capture or raw binary log, up to BENCH_BYTES. Capture record headers
+			// (also the repeated file headers of appended captures) are skipped by the transport
+			oem7::FileTransport file;
+			if (!file.open(path)) {
+				PRINT("Error opening %s\n", path);
+				return;
+			}
+			size = 0;
+			while (!file.atEnd() && size < sizeof(stream)) {
+				const int n = file.read(&stream[size], sizeof(stream) - size);
+				if (n <= 0) break;
+				size += static_cast<size_t>(n);
+			}
+			bench(path, size, 0);
+			return;
+		}
+#else
+		(void)path;
+#endif
+		size = generate(20, intact);
+		bench("corrupted 2%", size, intact);
+	}
+}
+
+#if defined(ESP32)
+void setup()
+{
+  Serial.begin(115200);
+  delay(1000);
+  Serial.printf("CPU %u MHz\n", static_cast<unsigned>(ESP.getCpuFreqMHz()));
+  run(nullptr);
+}
+
+void loop()
+{
+  delay(1000);
+}
+#else
+int main(int argc, char** argv)
+{
+	run(argc > 1 ? argv[1] : nullptr);
+	return parallel() ? 0 : 1;
+}
+#endif
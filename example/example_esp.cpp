@@ -12,6 +12,8 @@ void setup()
 {
   Serial.begin(115200);
   serial.begin(115200, SERIAL_8N1, 5, 18);
+  // Find the receiver rate and step up to the fastest clean one
+  Serial.printf("Baud: %u\n", static_cast<unsigned>(gnss.negotiate()));
   gnss.begin();
   // Print Version
   const uint32_t vx	= gnss.versionComponent();
@@ -36,6 +38,8 @@ void loop()
   static uint32_t year;
   static uint8_t month, day, hour, minute, second;
 
+  // Sleep until the UART receive event instead of spinning
+  if (!gnss.wait(100)) return;
   gnss.update();
   if (!gnss.isValid()) return;
 
@@ -0,0 +1,67 @@
+/// \file       example_multi.cpp
+/// \brief      This example how to poll two oem7::Receiver instances from two threads by Win32 or POSIX
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Receiver.h"
+
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <iostream>
+
+#ifdef _WIN32
+#define PORT1 "\\\\.\\COM3"
+#define PORT2 "\\\\.\\COM4"
+#else
+#define PORT1 "/dev/ttyUSB0"
+#define PORT2 "/dev/ttyUSB1"
+#endif
+
+// Frame buffer for the second card: larger than default for long logs
+static uint8_t buffer2[2048];
+
+int main(int argc, char** argv)
+{
+	serialib serial1, serial2;
+	if (serial1.openDevice(PORT1, 115200) != 1 || serial2.openDevice(PORT2, 115200) != 1) {
+		printf("Error opening %s or %s\n", PORT1, PORT2);
+		return -1;
+	}
+	// Each receiver has own parse state and buffers
+	oem7::Receiver gnss1(serial1);
+	oem7::Receiver gnss2(serial2, buffer2, sizeof(buffer2));
+#ifndef _WIN32
+	// wait() sleeps in poll() until data arrives
+	gnss1.watch(PORT1);
+	gnss2.watch(PORT2);
+#endif
+	gnss1.begin();
+	gnss2.begin();
+	// Poll receivers in parallel: no locking between instances
+	std::atomic_bool run = true;
+	auto poll = [&run](oem7::Receiver& gnss, const char* name) {
+		while (run.load() == true) {
+			if (!gnss.wait(100)) continue;
+			gnss.update();
+			if (!gnss.isValid()) continue;
+			printf("%s: lat = %.09f, lon = %.09f, heading = %.02f\n", name, gnss.lat(), gnss.lon(), gnss.heading());
+		}
+	};
+	std::thread thread1(poll, std::ref(gnss1), PORT1);
+	std::thread thread2(poll, std::ref(gnss2), PORT2);
+	// Quit Ctrl
+	std::cout << "\nENTER 'q' for Quit" << std::endl;
+	std::string command;
+	while (run.load() == true) {
+		std::cin >> command;
+		if (command[0] == 'q') run.store(false);
+	}
+	thread1.join();
+	thread2.join();
+	// Exit
+	gnss1.stop();
+	gnss2.stop();
+	serial1.closeDevice();
+	serial2.closeDevice();
+	return 0;
+}
@@ -0,0 +1,73 @@
+/// \file       example_pool.cpp
+/// \brief      This example how to run many oem7::BasicReceiver instances over TCP on a few worker threads by Win32 or POSIX
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Pool.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+typedef oem7::BasicReceiver<oem7::TcpTransport> TcpReceiver;
+
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		printf("Usage: %s host:port [host:port ...]\n", argv[0]);
+		return -1;
+	}
+	// Pool is large (output rings of all workers): not on the stack
+	std::unique_ptr<oem7::ReceiverPool<oem7::TcpTransport>> pool(new oem7::ReceiverPool<oem7::TcpTransport>());
+	std::vector<std::unique_ptr<oem7::TcpTransport>> links;
+	std::vector<std::unique_ptr<TcpReceiver>> receivers;
+	std::vector<const char*> names;
+	for (int i = 1; i < argc; ++i) {
+		std::string host = argv[i];
+		const size_t colon = host.rfind(':');
+		const uint16_t port = static_cast<uint16_t>(colon == std::string::npos ? 3001 : atoi(host.c_str() + colon + 1));
+		if (colon != std::string::npos) host.resize(colon);
+		links.emplace_back(new oem7::TcpTransport());
+		if (!links.back()->connect(host.c_str(), port)) {
+			printf("Error connecting %s\n", argv[i]);
+			links.pop_back();
+			continue;
+		}
+		// Commands before the pool starts
+		receivers.emplace_back(new TcpReceiver(*links.back()));
+		receivers.back()->begin();
+		if (pool->add(*receivers.back()) >= 0) names.push_back(argv[i]);
+	}
+	if (!pool->start()) {
+		printf("No receivers\n");
+		return -1;
+	}
+	printf("%u receivers on %u workers\n", static_cast<unsigned>(pool->size()), pool->workers());
+	// Quit Ctrl
+	std::atomic_bool run = true;
+	std::thread([&] {
+		std::cout << "\nENTER 'q' for Quit" << std::endl;
+		std::string command;
+		while (run.load() == true) {
+			std::cin >> command;
+			if (command[0] == 'q') run.store(false);
+		}
+	}).detach();
+	// Merged output of all receivers
+	oem7::PoolRecord record;
+	while (run.load() == true) {
+		if (!pool->pop(record)) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			continue;
+		}
+		const oem7::MessageView<oem7::DualAntHeading> hdg(record.record.frame(), oem7::MSG_DUALANTHEADING);
+		if (hdg) printf("%s: heading = %.02f\n", names[record.link], hdg->heading);
+	}
+	pool->stop();
+	// Exit
+	for (auto& receiver : receivers) receiver->stop();
+	return 0;
+}
@@ -61,6 +61,7 @@ int main(int argc, char** argv)
 	uint32_t year;
 	uint8_t month, day, hour, minute, second;
 	while (run.load() == true) {
+		if (!gnss.wait(100)) continue;
 		gnss.update();
 		
 		if (!gnss.isValid()) continue;
@@ -0,0 +1,126 @@
+/// \file       Capture.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Capture.h"
+#include <string.h>
+
+namespace {
+	const uint8_t header[oem7::CAPTURE_HEADER] = { 'O', 'E', 'M', '7', 'C', 'A', 'P', oem7::CAPTURE_VERSION };
+}
+
+// Record header never matches the file header: its size field "CA" is too long
+static_assert(OEM7_CAPTURE_RECORD < ('C' | ('A' << 8)), "OEM7_CAPTURE_RECORD is too long");
+
+oem7::CaptureWriter::CaptureWriter(CaptureWrite fn, void* context) : _fn(fn), _context(context)
+{
+	put(&header[0], sizeof(header));
+}
+
+oem7::CaptureWriter::~CaptureWriter()
+{
+	flush();
+}
+
+void oem7::CaptureWriter::add(const uint32_t time, const uint8_t* data, size_t size)
+{
+	while (size > 0) {
+		const uint16_t n = static_cast<uint16_t>(size < OEM7_CAPTURE_RECORD ? size : OEM7_CAPTURE_RECORD);
+		uint8_t head[CAPTURE_RECORD_HEAD];
+		memcpy(&head[0], &time, sizeof(time));
+		memcpy(&head[sizeof(time)], &n, sizeof(n));
+		put(&head[0], sizeof(head));
+		put(data, n);
+		data += n;
+		size -= n;
+	}
+}
+
+bool oem7::CaptureWriter::flush()
+{
+	if (_used == 0) return true;
+	const size_t n = _fn != nullptr ? _fn(&_chunk[0], _used, _context) : 0;
+	_written += static_cast<uint32_t>(n);
+	if (n < _used) _lost += static_cast<uint32_t>(_used - n);
+	const bool ok = (n == _used);
+	_used = 0;
+	return ok;
+}
+
+void oem7::CaptureWriter::put(const uint8_t* data, size_t size)
+{
+	while (size > 0) {
+		if (_used == sizeof(_chunk)) flush();
+		const size_t room = sizeof(_chunk) - _used;
+		const size_t n = size < room ? size : room;
+		memcpy(&_chunk[_used], data, n);
+		_used += n;
+		data += n;
+		size -= n;
+	}
+}
+
+#if !defined(ESP8266)
+size_t oem7::CaptureWriter::toFile(const uint8_t* data, size_t size, void* file)
+{
+	return fwrite(data, 1, size, static_cast<FILE*>(file));
+}
+#endif
+
+#if defined(ESP8266) || defined(ESP32)
+size_t oem7::CaptureWriter::toStream(const uint8_t* data, size_t size, void* stream)
+{
+	return static_cast<Stream*>(stream)->write(data, size);
+}
+#endif
+
+oem7::CaptureReader::CaptureReader(CaptureRead fn, void* context) : _fn(fn), _context(context)
+{
+}
+
+bool oem7::CaptureReader::next(CaptureChunk& chunk)
+{
+	if (_failed || _fn == nullptr) return false;
+	if (!_started) {
+		uint8_t head[CAPTURE_HEADER];
+		if (_fn(&head[0], sizeof(head), _context) != sizeof(head) || memcmp(&head[0], &header[0], sizeof(head)) != 0) {
+			_failed = true;
+			return false;
+		}
+		_started = true;
+	}
+	uint8_t head[CAPTURE_HEADER];
+	// End of capture, possibly cut inside the record header
+	if (_fn(&head[0], CAPTURE_RECORD_HEAD, _context) != CAPTURE_RECORD_HEAD) return false;
+	// File header of a capture appended to this one: its size field is beyond OEM7_CAPTURE_RECORD
+	while (memcmp(&head[0], &header[0], CAPTURE_RECORD_HEAD) == 0) {
+		const size_t rest = CAPTURE_HEADER - CAPTURE_RECORD_HEAD;
+		if (_fn(&head[CAPTURE_RECORD_HEAD], rest, _context) != rest || memcmp(&head[0], &header[0], sizeof(head)) != 0) {
+			_failed = true;
+			return false;
+		}
+		if (_fn(&head[0], CAPTURE_RECORD_HEAD, _context) != CAPTURE_RECORD_HEAD) return false;
+	}
+	memcpy(&chunk.time, &head[0], sizeof(chunk.time));
+	memcpy(&chunk.size, &head[sizeof(chunk.time)], sizeof(chunk.size));
+	if (chunk.size > sizeof(chunk.data)) {
+		_failed = true;
+		return false;
+	}
+	return _fn(&chunk.data[0], chunk.size, _context) == chunk.size;
+}
+
+#if !defined(ESP8266)
+size_t oem7::CaptureReader::fromFile(uint8_t* data, size_t size, void* file)
+{
+	return fread(data, 1, size, static_cast<FILE*>(file));
+}
+#endif
+
+#if defined(ESP8266) || defined(ESP32)
+size_t oem7::CaptureReader::fromStream(uint8_t* data, size_t size, void* stream)
+{
+	return static_cast<Stream*>(stream)->readBytes(data, size);
+}
+#endif
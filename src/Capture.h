@@ -0,0 +1,155 @@
+/// \file       Capture.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_CAPTURE_H__
+#define __OEM7_CAPTURE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#if !defined(ESP8266)
+#include <stdio.h>
+#endif
+#if defined(ESP8266) || defined(ESP32)
+#include "Stream.h"
+#endif
+
+/// \def OEM7_CAPTURE_CHUNK
+/// \brief Write chunk of oem7::CaptureWriter (in bytes)
+/// \details Records are collected and written in chunks: SD card sector by default. Declare in build flags to override
+#ifndef OEM7_CAPTURE_CHUNK
+# define OEM7_CAPTURE_CHUNK 512
+#endif
+/// \def OEM7_CAPTURE_RECORD
+/// \brief The longest record payload (in bytes), longer reads are split
+#ifndef OEM7_CAPTURE_RECORD
+# define OEM7_CAPTURE_RECORD 256
+#endif
+
+namespace oem7 {
+    /// \brief Capture output
+    /// \param data Bytes
+    /// \param size Number of bytes
+    /// \param context User context passed at construction
+    /// \return Number of bytes written
+    typedef size_t (*CaptureWrite)(const uint8_t* data, size_t size, void* context);
+    /// \brief Capture input
+    /// \param data Buffer
+    /// \param size Number of bytes to read
+    /// \param context User context passed at construction
+    /// \return Number of bytes read, less than \c size at the end of capture
+    typedef size_t (*CaptureRead)(uint8_t* data, size_t size, void* context);
+
+    /// \brief Capture format
+    /// \details File starts with \c "OEM7CAP" and version byte, followed by records:
+    /// \details \c uint32_t host monotonic time (us), \c uint16_t payload size and the bytes of one serial read.
+    /// \details Little-endian. Append-only: a capture cut by power loss is valid up to its last complete record.
+    /// \details A file opened for append gets the header of each writer: readers skip repeated headers between records
+    /// \ingroup oem7rec
+    enum {
+        CAPTURE_VERSION     = 1,    ///< Format version
+        CAPTURE_HEADER      = 8,    ///< File header size (in bytes)
+        CAPTURE_RECORD_HEAD = 6     ///< Record header size (in bytes)
+    };
+    /// \struct oem7::CaptureChunk Capture.h
+    /// \brief Bytes of one serial read
+    /// \ingroup oem7rec
+    struct CaptureChunk {
+        uint32_t time{ 0 };                         ///< Host monotonic receive time (us)
+        uint16_t size{ 0 };                         ///< Number of bytes
+        uint8_t data[OEM7_CAPTURE_RECORD]{};        ///< Bytes
+    };
+
+    /// \class oem7::CaptureWriter Capture.h
+    /// \brief Writes raw received bytes with host timestamps, see \c Receiver::capture()
+    /// \details Records are collected into a chunk of \c OEM7_CAPTURE_CHUNK bytes, so the output sees sector-sized
+    /// \details appends only. Example: \code
+    /// FILE* file = fopen("field.cap", "wb");
+    /// oem7::CaptureWriter capture(&oem7::CaptureWriter::toFile, file);
+    /// gnss.capture(&capture);
+    /// ...
+    /// gnss.capture(nullptr);
+    /// capture.flush();
+    /// \endcode
+    /// \ingroup oem7rec
+    class CaptureWriter {
+        CaptureWriter() = delete;
+        CaptureWriter(const CaptureWriter&) = delete;
+        CaptureWriter& operator = (const CaptureWriter&) = delete;
+    public:
+        /// \brief Constructor
+        /// \param fn Output
+        /// \param context User context passed to output
+        CaptureWriter(CaptureWrite fn, void* context);
+        /// \brief Destructor: writes the last chunk
+        ~CaptureWriter();
+    public:
+        /// \brief Append bytes of one serial read
+        /// \param time Host monotonic receive time (us)
+        /// \param data Bytes
+        /// \param size Number of bytes
+        void add(const uint32_t time, const uint8_t* data, size_t size);
+        /// \brief Write collected records
+        /// \return \c false if output failed
+        bool flush();
+        /// \return Number of bytes written
+        inline uint32_t written() const { return _written; }
+        /// \return Number of bytes lost by output failures
+        inline uint32_t lost() const { return _lost; }
+#if !defined(ESP8266)
+        /// \brief Output to \c FILE opened for binary write or append
+        static size_t toFile(const uint8_t* data, size_t size, void* file);
+#endif
+#if defined(ESP8266) || defined(ESP32)
+        /// \brief Output to Arduino \c Stream, e.g. SD or LittleFS \c File
+        static size_t toStream(const uint8_t* data, size_t size, void* stream);
+#endif
+    private:
+        /// \brief Collect bytes, writing full chunks
+        void put(const uint8_t* data, size_t size);
+    private:
+        CaptureWrite _fn;
+        void* _context;
+        uint8_t _chunk[OEM7_CAPTURE_CHUNK];
+        size_t _used{ 0 };
+        uint32_t _written{ 0 };
+        uint32_t _lost{ 0 };
+    };
+
+    /// \class oem7::CaptureReader Capture.h
+    /// \brief Reads records of a capture, see \c Receiver::replay()
+    /// \ingroup oem7rec
+    class CaptureReader {
+        CaptureReader() = delete;
+        CaptureReader(const CaptureReader&) = delete;
+        CaptureReader& operator = (const CaptureReader&) = delete;
+    public:
+        /// \brief Constructor
+        /// \param fn Input
+        /// \param context User context passed to input
+        CaptureReader(CaptureRead fn, void* context);
+    public:
+        /// \brief Read next record
+        /// \param chunk Record
+        /// \return \c false at the end of capture or if it is not a capture of this version
+        bool next(CaptureChunk& chunk);
+        /// \return Input is not a capture or record is broken
+        inline bool failed() const { return _failed; }
+#if !defined(ESP8266)
+        /// \brief Input from \c FILE opened for binary read
+        static size_t fromFile(uint8_t* data, size_t size, void* file);
+#endif
+#if defined(ESP8266) || defined(ESP32)
+        /// \brief Input from Arduino \c Stream
+        static size_t fromStream(uint8_t* data, size_t size, void* stream);
+#endif
+    private:
+        CaptureRead _fn;
+        void* _context;
+        bool _started{ false };
+        bool _failed{ false };
+    };
+}
+
+#endif // __OEM7_CAPTURE_H__
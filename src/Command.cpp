@@ -0,0 +1,161 @@
+/// \file       Command.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Command.h"
+#include "Crc32.h"
+#include <string.h>
+
+oem7::BinaryCommand oem7::BinaryCommand::log(const uint32_t port, const uint16_t msgId, const uint32_t trigger, const double period)
+{
+	LogCommand data{};
+	data.port = port;
+	data.msgId = msgId;
+	data.trigger = trigger;
+	data.period = period;
+	return make(MSG_LOG, data);
+}
+
+oem7::BinaryCommand oem7::BinaryCommand::unlogAll(const uint32_t port, const bool held)
+{
+	UnlogAllCommand data{};
+	data.port = port;
+	data.held = held ? 1 : 0;
+	return make(MSG_UNLOGALL, data);
+}
+
+oem7::BinaryCommand oem7::BinaryCommand::statusConfig(const uint32_t type, const uint32_t word, const uint32_t mask)
+{
+	StatusConfigCommand data{};
+	data.type = type;
+	data.word = word;
+	data.mask = mask;
+	return make(MSG_STATUSCONFIG, data);
+}
+
+oem7::BinaryCommand oem7::BinaryCommand::serialConfig(const uint32_t port, const uint32_t baud)
+{
+	SerialConfigCommand data{};
+	data.port = port;
+	data.baud = baud;
+	data.dataBits = 8;
+	data.stopBits = 1;
+	data.breakDetect = 1;
+	return make(MSG_SERIALCONFIG, data);
+}
+
+oem7::BinaryCommand oem7::BinaryCommand::antennaRemove(const uint32_t type)
+{
+	AntennaTypeCommand data{};
+	data.action = ANTENNA_REMOVE;
+	data.type = type;
+	return make(MSG_ANTENNATYPE, data);
+}
+
+size_t oem7::BinaryCommand::encode(uint8_t* data, const size_t size) const
+{
+	const size_t total = HEAD_LENGHT + this->size + sizeof(uint32_t);
+	if (data == nullptr || size < total || this->size > sizeof(body)) return 0;
+	Head head{};
+	head.msgId = msgId;
+	head.portAddress = PORT_THISPORT;
+	head.msgLenght = this->size;
+	data[0] = HEAD_SYNC_1;
+	data[1] = HEAD_SYNC_2;
+	data[2] = HEAD_SYNC_3;
+	data[3] = HEAD_LENGHT;
+	memcpy(&data[4], &head, sizeof(Head));
+	memcpy(&data[HEAD_LENGHT], &body[0], this->size);
+	const uint32_t crc = Crc32::compute(&data[0], HEAD_LENGHT + this->size);
+	memcpy(&data[HEAD_LENGHT + this->size], &crc, sizeof(uint32_t));
+	return total;
+}
+
+bool oem7::CommandQueue::push(const char* command, CommandHandler fn, void* context, const unsigned long timeout)
+{
+	if (command == nullptr || _count >= OEM7_COMMANDS) return false;
+	_queue[(_head + _count) % OEM7_COMMANDS] = Entry{ command, BinaryCommand{}, fn, context, timeout, 0 };
+	++_count;
+	return true;
+}
+
+bool oem7::CommandQueue::push(const BinaryCommand& command, CommandHandler fn, void* context, const unsigned long timeout)
+{
+	if (command.msgId == 0 || _count >= OEM7_COMMANDS) return false;
+	_queue[(_head + _count) % OEM7_COMMANDS] = Entry{ nullptr, command, fn, context, timeout, 0 };
+	++_count;
+	return true;
+}
+
+const oem7::CommandQueue::Entry* oem7::CommandQueue::next() const
+{
+	if (_inflight >= _count || _inflight >= OEM7_COMMAND_WINDOW) return nullptr;
+	return &_queue[(_head + _inflight) % OEM7_COMMANDS];
+}
+
+void oem7::CommandQueue::sent(const unsigned long now)
+{
+	if (_inflight >= _count) return;
+	_queue[(_head + _inflight) % OEM7_COMMANDS].sent = now;
+	++_inflight;
+}
+
+void oem7::CommandQueue::expire(const unsigned long now)
+{
+	// Commands of one port are answered in order: only the oldest one may time out first
+	while (_inflight > 0) {
+		const Entry& entry = _queue[_head];
+		if (now - entry.sent <= entry.timeout) return;
+		complete(CMD_TIMEOUT, "");
+	}
+}
+
+void oem7::CommandQueue::text(const uint8_t* data, size_t size)
+{
+	// Response: \r\n<OK\r\n[COM1] or \r\n<ERROR:Message text\r\n[COM1]
+	for (size_t i = 0; i < size; ++i) {
+		const char c = static_cast<char>(data[i]);
+		if (c == '<') _lineLen = 0;
+		if (c != '\r' && c != '\n') {
+			if (_lineLen < LINE_SIZE - 1) _line[_lineLen++] = c;
+			continue;
+		}
+		if (_lineLen == 0) continue;
+		_line[_lineLen] = '\0';
+		_lineLen = 0;
+		if (_inflight == 0) continue;
+		if (strncmp(_line, "<OK", 3) == 0) complete(CMD_OK, &_line[1]);
+		else if (strncmp(_line, "<ERROR", 6) == 0) complete(CMD_ERROR, &_line[1]);
+	}
+}
+
+void oem7::CommandQueue::response(const Frame& frame)
+{
+	// Response body: Response ID followed by response text
+	if (_inflight == 0 || frame.size < sizeof(uint32_t)) return;
+	uint32_t id = 0;
+	memcpy(&id, frame.body, sizeof(uint32_t));
+	size_t n = frame.size - sizeof(uint32_t);
+	if (n > LINE_SIZE - 1) n = LINE_SIZE - 1;
+	memcpy(&_line[0], frame.body + sizeof(uint32_t), n);
+	_line[n] = '\0';
+	_lineLen = 0;
+	complete(id == RESPONSE_OK ? CMD_OK : CMD_ERROR, &_line[0]);
+}
+
+void oem7::CommandQueue::complete(const CommandStatus status, const char* reply)
+{
+	// Entry is removed before the call, so the handler may queue next command
+	const Entry entry = _queue[_head];
+	_head = (_head + 1) % OEM7_COMMANDS;
+	--_count;
+	--_inflight;
+	if (entry.fn == nullptr) return;
+	CommandResult result;
+	result.command = entry.command;
+	result.reply = reply;
+	result.msgId = entry.command ? 0 : entry.binary.msgId;
+	result.status = status;
+	entry.fn(result, entry.context);
+}
@@ -0,0 +1,184 @@
+/// \file       Command.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_COMMAND_H__
+#define __OEM7_COMMAND_H__
+
+#include "Message.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// \def OEM7_COMMANDS
+/// \brief Capacity of the command queue
+/// \details Declare in build flags to override
+#ifndef OEM7_COMMANDS
+# define OEM7_COMMANDS 32
+#endif
+/// \def OEM7_COMMAND_WINDOW
+/// \brief Number of commands sent ahead of their replies
+/// \details Bounded by the receiver input buffer. Declare in build flags to override
+#ifndef OEM7_COMMAND_WINDOW
+# define OEM7_COMMAND_WINDOW 4
+#endif
+/// \def OEM7_COMMAND_BODY
+/// \brief Body capacity of oem7::BinaryCommand (in bytes)
+/// \details Fits every binary command of this library
+#ifndef OEM7_COMMAND_BODY
+# define OEM7_COMMAND_BODY 32
+#endif
+/// \def OEM7_COMMAND_TIMEOUT
+/// \brief Default reply timeout of a command (in ms)
+#ifndef OEM7_COMMAND_TIMEOUT
+# define OEM7_COMMAND_TIMEOUT 1000
+#endif
+
+namespace oem7 {
+    /// \brief Command completion status
+    /// \ingroup oem7rec
+    enum CommandStatus : uint8_t {
+        CMD_OK      = 0,    ///< Receiver replied \c <OK
+        CMD_ERROR   = 1,    ///< Receiver replied \c <ERROR, see reply text
+        CMD_TIMEOUT = 2     ///< No reply in time
+    };
+    /// \struct oem7::CommandResult Command.h
+    /// \brief Command completion
+    /// \ingroup oem7rec
+    struct CommandResult {
+        const char* command{ nullptr }; ///< Command text or \c nullptr for binary command
+        const char* reply{ "" };        ///< Reply text, valid during the call only
+        uint16_t msgId{ 0 };            ///< Binary command ID or 0 for ASCII command
+        CommandStatus status{ CMD_OK }; ///< Completion status
+    };
+    /// \struct oem7::BinaryCommand Command.h
+    /// \brief Binary command body
+    /// \details Header and CRC are added by \c encode(), with the same oem7::Head layout and CRC as logs
+    /// \details See: https://docs.novatel.com/OEM7/Content/Messages/Binary.htm
+    /// \ingroup oem7rec
+    struct BinaryCommand {
+        uint16_t msgId{ 0 };                    ///< Command ID
+        uint16_t size{ 0 };                     ///< Body size (in bytes)
+        uint8_t body[OEM7_COMMAND_BODY]{};      ///< Command body
+        /// \brief Command of body structure
+        /// \tparam T Body structure: oem7::LogCommand, oem7::UnlogAllCommand etc
+        /// \param msgId Command ID
+        /// \param data Body
+        template <typename T>
+        static BinaryCommand make(const uint16_t msgId, const T& data)
+        {
+            static_assert(sizeof(T) <= OEM7_COMMAND_BODY, "Command body does not fit into OEM7_COMMAND_BODY");
+            BinaryCommand cmd;
+            cmd.msgId = msgId;
+            cmd.size = sizeof(T);
+            memcpy(&cmd.body[0], &data, sizeof(T));
+            return cmd;
+        }
+        /// \brief \c LOG command
+        /// \param port Output port (See: \b Detailed \b Port \b Identifier enumerator)
+        /// \param msgId Message ID of log (binary format)
+        /// \param trigger Trigger (See: \b Log \b Trigger enumerator)
+        /// \param period Period for \c ONTIME trigger (s)
+        static BinaryCommand log(const uint32_t port, const uint16_t msgId, const uint32_t trigger, const double period = 0.0);
+        /// \brief \c UNLOGALL command
+        /// \param port Port to clear (See: \b Detailed \b Port \b Identifier enumerator)
+        /// \param held Remove held logs too
+        static BinaryCommand unlogAll(const uint32_t port, const bool held);
+        /// \brief \c STATUSCONFIG command
+        /// \param type Mask type (See: \b STATUSCONFIG \b Mask \b Type enumerator)
+        /// \param word Status word (See: \b Status \b Word enumerator)
+        /// \param mask Mask
+        static BinaryCommand statusConfig(const uint32_t type, const uint32_t word, const uint32_t mask);
+        /// \brief \c SERIALCONFIG command, 8N1 without handshake and with break detection
+        /// \param port Port (See: \b Serial \b Port \b Identifier enumerator)
+        /// \param baud Baud rate
+        static BinaryCommand serialConfig(const uint32_t port, const uint32_t baud);
+        /// \brief \c ANTENNATYPE \c REMOVE command
+        /// \param type Antenna type (See: \b User-Defined \b Antenna \b Type enumerator)
+        static BinaryCommand antennaRemove(const uint32_t type);
+        /// \brief Frame command: header, body and CRC
+        /// \param data Output buffer, \c HEAD_LENGHT + \c OEM7_COMMAND_BODY + 4 bytes are enough
+        /// \param size Output buffer size
+        /// \return Frame size or 0 if buffer is too small
+        size_t encode(uint8_t* data, const size_t size) const;
+    };
+    /// \brief Command completion handler
+    /// \param result Command completion
+    /// \param context User context passed with the command
+    typedef void (*CommandHandler)(const CommandResult& result, void* context);
+
+    /// \class oem7::CommandQueue Command.h
+    /// \brief Pipelined abbreviated ASCII and binary commands
+    /// \details Up to \c OEM7_COMMAND_WINDOW commands are sent without waiting for replies.
+    /// \details The receiver answers commands of one port in order, so each \c <OK or \c <ERROR line or binary response
+    /// \details completes the oldest command in flight. Reply text is taken from bytes outside binary frames (see \c Framer::onText())
+    /// \details Fixed capacity, no heap allocation. Command text is not copied and must outlive the completion
+    /// \details See: https://docs.novatel.com/OEM7/Content/Messages/Responses.htm
+    /// \ingroup oem7rec
+    class CommandQueue {
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator = (const CommandQueue&) = delete;
+    public:
+        /// \brief Constructor
+        CommandQueue() {}
+    public:
+        /// \brief Queued command
+        struct Entry {
+            const char* command;    ///< ASCII command or \c nullptr
+            BinaryCommand binary;   ///< Binary command if \c command is \c nullptr
+            CommandHandler fn;      ///< Completion handler
+            void* context;          ///< User context
+            unsigned long timeout;  ///< Reply timeout (ms)
+            unsigned long sent;     ///< Send time (ms)
+        };
+    public:
+        /// \brief Queue command
+        /// \param command Abbreviated ASCII command without line end
+        /// \param fn Completion handler (may be \c nullptr)
+        /// \param context User context
+        /// \param timeout Reply timeout after sending (in ms)
+        /// \return \c false if queue is full
+        bool push(const char* command, CommandHandler fn, void* context, const unsigned long timeout);
+        /// \brief Queue binary command
+        /// \param command Binary command, copied
+        /// \param fn Completion handler (may be \c nullptr)
+        /// \param context User context
+        /// \param timeout Reply timeout after sending (in ms)
+        /// \return \c false if queue is full
+        bool push(const BinaryCommand& command, CommandHandler fn, void* context, const unsigned long timeout);
+        /// \return Next command to send or \c nullptr if none is waiting or window is full
+        const Entry* next() const;
+        /// \brief Mark command returned by \c next() as sent
+        /// \param now Current time (in ms)
+        void sent(const unsigned long now);
+        /// \brief Complete commands without reply in time
+        /// \param now Current time (in ms)
+        void expire(const unsigned long now);
+        /// \brief Scan text received outside binary frames for replies
+        /// \param data Text bytes
+        /// \param size Number of bytes
+        void text(const uint8_t* data, size_t size);
+        /// \brief Complete command by binary response
+        /// \param frame Frame with \c MSGTYPE_RESPONSE bit
+        void response(const Frame& frame);
+        /// \return Number of queued and in-flight commands
+        inline size_t size() const { return _count; }
+        /// \return No command is waiting
+        inline bool empty() const { return _count == 0; }
+    public:
+        /// \brief Reply line buffer size: longer replies are cut
+        enum { LINE_SIZE = 64 };
+    private:
+        /// \brief Complete the oldest command in flight
+        void complete(const CommandStatus status, const char* reply);
+    private:
+        Entry _queue[OEM7_COMMANDS]{};
+        size_t _head{ 0 };
+        size_t _count{ 0 };
+        size_t _inflight{ 0 };
+        size_t _lineLen{ 0 };
+        char _line[LINE_SIZE]{};
+    };
+}
+
+#endif // __OEM7_COMMAND_H__
@@ -0,0 +1,67 @@
+/// \file       Config.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_CONFIG_H__
+#define __OEM7_CONFIG_H__
+
+/// \def OEM7_COMPACT
+/// \brief Defaults for small MCUs: the position and heading snapshot only
+/// \details 1 - no \c VERSION, \c HWMONITOR, \c HEADING2 and \c INSATTS storage, no status descriptions, frame buffer
+/// \details of the largest enabled log, no background reader, smaller queues and log ring, log level \c WARNING.
+/// \details Each of these macros may still be declared on its own. Declare in build flags to override
+#ifndef OEM7_COMPACT
+# define OEM7_COMPACT 0
+#endif
+
+#if OEM7_COMPACT
+# ifndef OEM7_MSG_VERSION
+#  define OEM7_MSG_VERSION 0
+# endif
+# ifndef OEM7_MSG_HWMONITOR
+#  define OEM7_MSG_HWMONITOR 0
+# endif
+# ifndef OEM7_MSG_HEADING2
+#  define OEM7_MSG_HEADING2 0
+# endif
+# ifndef OEM7_MSG_INSATTS
+#  define OEM7_MSG_INSATTS 0
+# endif
+# ifndef OEM7_ROVERS
+#  define OEM7_ROVERS 1
+# endif
+# ifndef OEM7_STATUS_TEXT
+#  define OEM7_STATUS_TEXT 0
+# endif
+# ifndef OEM7_FRAME_FIT
+#  define OEM7_FRAME_FIT 1
+# endif
+# ifndef OEM7_READER
+#  define OEM7_READER 0
+# endif
+// Fits begin() with oem7::EVENT_PROFILE: 10 STATUSCONFIG and 6 LOG commands
+# ifndef OEM7_COMMANDS
+#  define OEM7_COMMANDS 16
+# endif
+# ifndef OEM7_EPOCHS
+#  define OEM7_EPOCHS 2
+# endif
+# ifndef OEM7_HANDLERS
+#  define OEM7_HANDLERS 4
+# endif
+# ifndef OEM7_STATS_MESSAGES
+#  define OEM7_STATS_MESSAGES 4
+# endif
+# ifndef OEM7_LOG_RECORDS
+#  define OEM7_LOG_RECORDS 4
+# endif
+# ifndef OEM7_LOG_LINE
+#  define OEM7_LOG_LINE 96
+# endif
+# if !defined(OEM7_LOG_LEVEL) && !defined(DEBUGLOG)
+#  define OEM7_LOG_LEVEL OEM7_LOG_WARNING
+# endif
+#endif
+
+#endif // __OEM7_CONFIG_H__
@@ -0,0 +1,92 @@
+/// \file       Crc32.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Crc32.h"
+#include <string.h>
+
+#if OEM7_CRC_ENGINE == OEM7_CRC_ROM
+# if defined(__has_include)
+#  if __has_include("esp_rom_crc.h")
+#   include "esp_rom_crc.h"
+#   define OEM7_ROM_CRC32 esp_rom_crc32_le
+#  endif
+# endif
+# ifndef OEM7_ROM_CRC32
+#  include "rom/crc.h"
+#  define OEM7_ROM_CRC32 crc32_le
+# endif
+#endif
+
+#if OEM7_CRC_ENGINE == OEM7_CRC_SLICE8 && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+// Slice-by-8 loads words in little endian byte order
+# undef OEM7_CRC_ENGINE
+# define OEM7_CRC_ENGINE OEM7_CRC_TABLE
+#endif
+
+namespace {
+	// Lookup tables: [0] is the classic byte table, [1..7] extend it for slice-by-8
+#if OEM7_CRC_ENGINE == OEM7_CRC_SLICE8
+	constexpr size_t SLICES = 8;
+#else
+	constexpr size_t SLICES = 1;
+#endif
+
+	struct Table {
+		uint32_t value[SLICES][256];
+	};
+
+	constexpr Table makeTable()
+	{
+		Table table{};
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t val = i;
+			for (uint8_t j = 8; j > 0; j--) val = (val & 1) ? (val >> 1) ^ oem7::Crc32::POLYNOMIAL : (val >> 1);
+			table.value[0][i] = val;
+		}
+		for (size_t s = 1; s < SLICES; ++s) {
+			for (uint32_t i = 0; i < 256; ++i) {
+				const uint32_t prev = table.value[s - 1][i];
+				table.value[s][i] = (prev >> 8) ^ table.value[0][prev & 0xFF];
+			}
+		}
+		return table;
+	}
+
+#if OEM7_CRC_ENGINE == OEM7_CRC_TABLE || OEM7_CRC_ENGINE == OEM7_CRC_SLICE8
+	constexpr Table TABLE = makeTable();
+	static_assert(TABLE.value[0][1] == 0x77073096UL, "CRC table generation");
+#endif
+}
+
+uint32_t oem7::Crc32::update(uint32_t crc, const uint8_t* buffer, size_t size)
+{
+#if OEM7_CRC_ENGINE == OEM7_CRC_ROM
+	// ROM routine inverts the CRC on entry and exit
+	return ~OEM7_ROM_CRC32(~crc, buffer, static_cast<uint32_t>(size));
+#elif OEM7_CRC_ENGINE == OEM7_CRC_BITWISE
+	while (size-- != 0) {
+		uint32_t val = (crc ^ *buffer++) & 0xFF;
+		for (uint8_t i = 8; i > 0; i--) val = (val & 1) ? (val >> 1) ^ POLYNOMIAL : (val >> 1);
+		crc = ((crc >> 8) & 0x00FFFFFFUL) ^ val;
+	}
+	return crc;
+#else
+# if OEM7_CRC_ENGINE == OEM7_CRC_SLICE8
+	const auto& t = TABLE.value;
+	while (size >= 8) {
+		uint32_t lo, hi;
+		memcpy(&lo, buffer, sizeof(lo));
+		memcpy(&hi, buffer + 4, sizeof(hi));
+		lo ^= crc;
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+			t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+		buffer += 8;
+		size -= 8;
+	}
+# endif
+	while (size-- != 0) crc = (crc >> 8) ^ TABLE.value[0][(crc ^ *buffer++) & 0xFF];
+	return crc;
+#endif
+}
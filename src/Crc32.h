@@ -0,0 +1,72 @@
+/// \file       Crc32.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_CRC32_H__
+#define __OEM7_CRC32_H__
+
+#include "oem7.h"
+#include <stddef.h>
+
+/// \brief CRC engine: bitwise reference implementation
+#define OEM7_CRC_BITWISE    0
+/// \brief CRC engine: 256-entry lookup table, one byte per step
+#define OEM7_CRC_TABLE      1
+/// \brief CRC engine: slice-by-8, eight bytes per step (8 KB of tables)
+#define OEM7_CRC_SLICE8     2
+/// \brief CRC engine: ESP32 ROM \c esp_rom_crc32_le
+#define OEM7_CRC_ROM        3
+
+/// \def OEM7_CRC_ENGINE
+/// \brief Selected CRC engine
+/// \details Declare in build flags to override. By default the ESP32 uses the ROM routine,
+/// \details other microcontrollers use the 1 KB table and PC builds use slice-by-8
+#ifndef OEM7_CRC_ENGINE
+# if defined(ESP32)
+#  define OEM7_CRC_ENGINE OEM7_CRC_ROM
+# elif defined(ESP8266) || defined(ARDUINO)
+#  define OEM7_CRC_ENGINE OEM7_CRC_TABLE
+# else
+#  define OEM7_CRC_ENGINE OEM7_CRC_SLICE8
+# endif
+#endif
+
+namespace oem7 {
+    /// \class oem7::Crc32 Crc32.h
+    /// \brief OEM7 32-bit CRC
+    /// \details Polynomial \c 0xEDB88320 (reflected), initial value 0, no final XOR
+    /// \details Supports incremental update so the CRC can be accumulated while bytes stream in
+    /// \details See: https://docs.novatel.com/OEM7/Content/Messages/32_Bit_CRC.htm
+    /// \ingroup oem7rec
+    class Crc32 {
+    public:
+        /// \brief Reflected CRC-32 polynomial
+        static constexpr uint32_t POLYNOMIAL = 0xEDB88320UL;
+    public:
+        /// \brief Restart accumulation
+        inline void reset() { _crc = 0; }
+        /// \brief Accumulate data block
+        /// \param buffer Data block buffer
+        /// \param size Data block size (in bytes)
+        inline void update(const uint8_t* buffer, size_t size) { _crc = update(_crc, buffer, size); }
+        /// \return CRC of all data accumulated since last \c reset()
+        inline uint32_t value() const { return _crc; }
+    public:
+        /// \brief Continue a CRC over a data block
+        /// \param crc CRC of the preceding data (0 for the first block)
+        /// \param buffer Data block buffer
+        /// \param size Data block size (in bytes)
+        /// \return CRC for data verification
+        static uint32_t update(uint32_t crc, const uint8_t* buffer, size_t size);
+        /// \brief Calculates the CRC-32 of a block of data all at once
+        /// \param buffer Data block buffer
+        /// \param size Data block size (in bytes)
+        /// \return CRC for data verification
+        static inline uint32_t compute(const uint8_t* buffer, size_t size) { return update(0, buffer, size); }
+    private:
+        uint32_t _crc{ 0 };
+    };
+}
+
+#endif // __OEM7_CRC32_H__
@@ -0,0 +1,263 @@
+/// \file       Diagnostics.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Diagnostics.h"
+
+#if OEM7_STATUS_TEXT
+# define OEM7_TEXT(text) text
+#else
+# define OEM7_TEXT(text) ""
+#endif
+
+namespace {
+	using oem7::StatusBit;
+	using oem7::SEVERITY_INFO;
+	using oem7::SEVERITY_WARNING;
+	using oem7::SEVERITY_ERROR;
+
+	// Documented bits only, see https://docs.novatel.com/OEM7/Content/Logs/RXSTATUS.htm
+	constexpr StatusBit errorBits[] = {
+		{ 0x00000001, 0x00000001, SEVERITY_ERROR, OEM7_TEXT("DRAM failure") },
+		{ 0x00000002, 0x00000002, SEVERITY_ERROR, OEM7_TEXT("Invalid firmware") },
+		{ 0x00000004, 0x00000004, SEVERITY_ERROR, OEM7_TEXT("ROM") },
+		{ 0x00000010, 0x00000010, SEVERITY_ERROR, OEM7_TEXT("ESN access") },
+		{ 0x00000020, 0x00000020, SEVERITY_ERROR, OEM7_TEXT("Authorization code") },
+		{ 0x00000080, 0x00000080, SEVERITY_ERROR, OEM7_TEXT("Supply voltage") },
+		{ 0x00000200, 0x00000200, SEVERITY_ERROR, OEM7_TEXT("Temperature status") },
+		{ 0x00000400, 0x00000400, SEVERITY_ERROR, OEM7_TEXT("MINOS status") },
+		{ 0x00000800, 0x00000800, SEVERITY_ERROR, OEM7_TEXT("PLL RF status") },
+		{ 0x00008000, 0x00008000, SEVERITY_ERROR, OEM7_TEXT("NVM status") },
+		{ 0x00010000, 0x00010000, SEVERITY_ERROR, OEM7_TEXT("Software resource limit exceeded") },
+		{ 0x00020000, 0x00020000, SEVERITY_ERROR, OEM7_TEXT("Model invalid for this receiver") },
+		{ 0x00100000, 0x00100000, SEVERITY_ERROR, OEM7_TEXT("Remote loading has begun") },
+		{ 0x00200000, 0x00200000, SEVERITY_ERROR, OEM7_TEXT("Export restriction") },
+		{ 0x00400000, 0x00400000, SEVERITY_ERROR, OEM7_TEXT("Safe Mode") },
+		{ 0x80000000, 0x80000000, SEVERITY_ERROR, OEM7_TEXT("Component hardware failure") }
+	};
+
+	constexpr StatusBit statusBits[] = {
+		{ 0x00000001, 0x00000001, SEVERITY_ERROR, OEM7_TEXT("Error") },
+		{ 0x00000002, 0x00000002, SEVERITY_WARNING, OEM7_TEXT("Temperature warning") },
+		{ 0x00000004, 0x00000004, SEVERITY_WARNING, OEM7_TEXT("Voltage supply warning") },
+		{ 0x00000008, 0x00000008, SEVERITY_ERROR, OEM7_TEXT("Primary antenna not powered") },
+		{ 0x00000010, 0x00000010, SEVERITY_ERROR, OEM7_TEXT("LNA Failure") },
+		{ 0x00000020, 0x00000020, SEVERITY_ERROR, OEM7_TEXT("Primary antenna open circuit") },
+		{ 0x00000040, 0x00000040, SEVERITY_ERROR, OEM7_TEXT("Primary antenna short circuit") },
+		{ 0x00000080, 0x00000080, SEVERITY_WARNING, OEM7_TEXT("CPU overload") },
+		{ 0x00000100, 0x00000100, SEVERITY_WARNING, OEM7_TEXT("COM buffer overrun") },
+		{ 0x00000200, 0x00000200, SEVERITY_WARNING, OEM7_TEXT("Spoofing detected") },
+		{ 0x00000800, 0x00000800, SEVERITY_WARNING, OEM7_TEXT("Link overrun") },
+		{ 0x00001000, 0x00001000, SEVERITY_WARNING, OEM7_TEXT("Input overrun") },
+		{ 0x00002000, 0x00002000, SEVERITY_WARNING, OEM7_TEXT("Aux transmit overrun") },
+		{ 0x00004000, 0x00004000, SEVERITY_ERROR, OEM7_TEXT("Antenna gain out of range") },
+		{ 0x00008000, 0x00008000, SEVERITY_WARNING, OEM7_TEXT("Jammer Detected") },
+		{ 0x00010000, 0x00010000, SEVERITY_INFO, OEM7_TEXT("INS reset") },
+		{ 0x00020000, 0x00020000, SEVERITY_WARNING, OEM7_TEXT("IMU communication failure") },
+		{ 0x00040000, 0x00040000, SEVERITY_ERROR, OEM7_TEXT("GPS almanac flag/UTC known") },
+		{ 0x00080000, 0x00080000, SEVERITY_ERROR, OEM7_TEXT("Position solution invalid") },
+		{ 0x00100000, 0x00100000, SEVERITY_INFO, OEM7_TEXT("Position fixed") },
+		{ 0x00200000, 0x00200000, SEVERITY_INFO, OEM7_TEXT("Clock steering disabled") },
+		{ 0x00400000, 0x00400000, SEVERITY_ERROR, OEM7_TEXT("Clock model invalid") },
+		{ 0x00800000, 0x00800000, SEVERITY_INFO, OEM7_TEXT("External oscillator locked") },
+		{ 0x01000000, 0x01000000, SEVERITY_WARNING, OEM7_TEXT("Software resource warning") },
+		{ 0x06000000, 0x00000000, SEVERITY_INFO, OEM7_TEXT("Interpret Status/Error Bits as OEM6 or earlier format") },
+		{ 0x06000000, 0x02000000, SEVERITY_INFO, OEM7_TEXT("Interpret Status/Error Bits as OEM7 format") },
+		{ 0x06000000, 0x04000000, SEVERITY_INFO, OEM7_TEXT("Reserved for a future version") },
+		{ 0x06000000, 0x06000000, SEVERITY_INFO, OEM7_TEXT("Reserved for a future version") },
+		{ 0x08000000, 0x08000000, SEVERITY_INFO, OEM7_TEXT("Tracking mode: HDR") },
+		{ 0x10000000, 0x10000000, SEVERITY_INFO, OEM7_TEXT("Digital Filtering Enabled") },
+		{ 0x20000000, 0x20000000, SEVERITY_INFO, OEM7_TEXT("Auxiliary 3 event") },
+		{ 0x40000000, 0x40000000, SEVERITY_INFO, OEM7_TEXT("Auxiliary 2 event") },
+		{ 0x80000000, 0x80000000, SEVERITY_INFO, OEM7_TEXT("Auxiliary 1 event") }
+	};
+
+	constexpr StatusBit aux1Bits[] = {
+		{ 0x00000001, 0x00000001, SEVERITY_WARNING, OEM7_TEXT("Jammer detected on RF1") },
+		{ 0x00000002, 0x00000002, SEVERITY_WARNING, OEM7_TEXT("Jammer detected on RF2") },
+		{ 0x00000004, 0x00000004, SEVERITY_WARNING, OEM7_TEXT("Jammer detected on RF3") },
+		{ 0x00000008, 0x00000008, SEVERITY_INFO, OEM7_TEXT("Position averaging on") },
+		{ 0x00000010, 0x00000010, SEVERITY_WARNING, OEM7_TEXT("Jammer detected on RF4") },
+		{ 0x00000020, 0x00000020, SEVERITY_WARNING, OEM7_TEXT("Jammer detected on RF5") },
+		{ 0x00000040, 0x00000040, SEVERITY_WARNING, OEM7_TEXT("Jammer detected on RF6") },
+		{ 0x00000080, 0x00000080, SEVERITY_INFO, OEM7_TEXT("USB not connected") },
+		{ 0x00000100, 0x00000100, SEVERITY_WARNING, OEM7_TEXT("USB1 buffer overrun") },
+		{ 0x00000200, 0x00000200, SEVERITY_WARNING, OEM7_TEXT("USB2 buffer overrun") },
+		{ 0x00000400, 0x00000400, SEVERITY_WARNING, OEM7_TEXT("USB3 buffer overrun") },
+		{ 0x00001000, 0x00001000, SEVERITY_WARNING, OEM7_TEXT("Profile activation error") },
+		{ 0x00002000, 0x00002000, SEVERITY_WARNING, OEM7_TEXT("Throttled ethernet reception") },
+		{ 0x00040000, 0x00040000, SEVERITY_INFO, OEM7_TEXT("Ethernet not connected") },
+		{ 0x00080000, 0x00080000, SEVERITY_WARNING, OEM7_TEXT("ICOM1 buffer overrun") },
+		{ 0x00100000, 0x00100000, SEVERITY_WARNING, OEM7_TEXT("ICOM2 buffer overrun") },
+		{ 0x00200000, 0x00200000, SEVERITY_WARNING, OEM7_TEXT("ICOM3 buffer overrun") },
+		{ 0x00400000, 0x00400000, SEVERITY_WARNING, OEM7_TEXT("NCOM1 buffer overrun") },
+		{ 0x00800000, 0x00800000, SEVERITY_WARNING, OEM7_TEXT("NCOM2 buffer overrun") },
+		{ 0x01000000, 0x01000000, SEVERITY_WARNING, OEM7_TEXT("NCOM3 buffer overrun") },
+		{ 0x40000000, 0x40000000, SEVERITY_WARNING, OEM7_TEXT("Status error reported by the IMU") },
+		{ 0x80000000, 0x80000000, SEVERITY_WARNING, OEM7_TEXT("IMU measurement outlier detected") }
+	};
+
+	constexpr StatusBit aux2Bits[] = {
+		{ 0x00000001, 0x00000001, SEVERITY_WARNING, OEM7_TEXT("SPI communication failure") },
+		{ 0x00000002, 0x00000002, SEVERITY_WARNING, OEM7_TEXT("I2C communication failure") },
+		{ 0x00000004, 0x00000004, SEVERITY_WARNING, OEM7_TEXT("COM4 buffer overrun") },
+		{ 0x00000008, 0x00000008, SEVERITY_WARNING, OEM7_TEXT("COM5 buffer overrun") },
+		{ 0x00000200, 0x00000200, SEVERITY_WARNING, OEM7_TEXT("COM1 buffer overrun") },
+		{ 0x00000400, 0x00000400, SEVERITY_WARNING, OEM7_TEXT("COM2 buffer overrun") },
+		{ 0x00000800, 0x00000800, SEVERITY_WARNING, OEM7_TEXT("COM3 buffer overrun") },
+		{ 0x00001000, 0x00001000, SEVERITY_WARNING, OEM7_TEXT("PLL RF1 unlock") },
+		{ 0x00002000, 0x00002000, SEVERITY_WARNING, OEM7_TEXT("PLL RF2 unlock") },
+		{ 0x00004000, 0x00004000, SEVERITY_WARNING, OEM7_TEXT("PLL RF3 unlock") },
+		{ 0x00008000, 0x00008000, SEVERITY_WARNING, OEM7_TEXT("PLL RF4 unlock") },
+		{ 0x00010000, 0x00010000, SEVERITY_WARNING, OEM7_TEXT("PLL RF5 unlock") },
+		{ 0x00020000, 0x00020000, SEVERITY_WARNING, OEM7_TEXT("PLL RF6 unlock") },
+		{ 0x00040000, 0x00040000, SEVERITY_WARNING, OEM7_TEXT("CCOM1 buffer overrun") },
+		{ 0x00080000, 0x00080000, SEVERITY_WARNING, OEM7_TEXT("CCOM2 buffer overrun") },
+		{ 0x00100000, 0x00100000, SEVERITY_WARNING, OEM7_TEXT("CCOM3 buffer overrun") },
+		{ 0x00200000, 0x00200000, SEVERITY_WARNING, OEM7_TEXT("CCOM4 buffer overrun") },
+		{ 0x00400000, 0x00400000, SEVERITY_WARNING, OEM7_TEXT("CCOM5 buffer overrun") },
+		{ 0x00800000, 0x00800000, SEVERITY_WARNING, OEM7_TEXT("CCOM6 buffer overrun") },
+		{ 0x01000000, 0x01000000, SEVERITY_WARNING, OEM7_TEXT("ICOM4 buffer overrun") },
+		{ 0x02000000, 0x02000000, SEVERITY_WARNING, OEM7_TEXT("ICOM5 buffer overrun") },
+		{ 0x04000000, 0x04000000, SEVERITY_WARNING, OEM7_TEXT("ICOM6 buffer overrun") },
+		{ 0x08000000, 0x08000000, SEVERITY_WARNING, OEM7_TEXT("ICOM7 buffer overrun") },
+		{ 0x10000000, 0x10000000, SEVERITY_ERROR, OEM7_TEXT("Secondary antenna not powered") },
+		{ 0x20000000, 0x20000000, SEVERITY_ERROR, OEM7_TEXT("Secondary antenna open circuit") },
+		{ 0x40000000, 0x40000000, SEVERITY_ERROR, OEM7_TEXT("Secondary antenna short circuit") },
+		{ 0x80000000, 0x80000000, SEVERITY_ERROR, OEM7_TEXT("Reset loop detected") }
+	};
+
+	constexpr StatusBit aux3Bits[] = {
+		{ 0x00000001, 0x00000001, SEVERITY_WARNING, OEM7_TEXT("SCOM buffer overrun") },
+		{ 0x00000002, 0x00000002, SEVERITY_WARNING, OEM7_TEXT("WCOM1 buffer overrun") },
+		{ 0x00000004, 0x00000004, SEVERITY_WARNING, OEM7_TEXT("FILE buffer overrun") },
+		{ 0x00000030, 0x00000000, SEVERITY_INFO, OEM7_TEXT("Antenna 1 gain in range") },
+		{ 0x00000030, 0x00000010, SEVERITY_ERROR, OEM7_TEXT("Antenna 1 gain high") },
+		{ 0x00000030, 0x00000020, SEVERITY_ERROR, OEM7_TEXT("Antenna 1 gain low") },
+		{ 0x00000030, 0x00000030, SEVERITY_ERROR, OEM7_TEXT("Antenna 1 gain anomaly") },
+		{ 0x000000C0, 0x00000000, SEVERITY_INFO, OEM7_TEXT("Antenna 2 gain in range") },
+		{ 0x000000C0, 0x00000040, SEVERITY_ERROR, OEM7_TEXT("Antenna 2 gain high") },
+		{ 0x000000C0, 0x00000080, SEVERITY_ERROR, OEM7_TEXT("Antenna 2 gain low") },
+		{ 0x000000C0, 0x000000C0, SEVERITY_ERROR, OEM7_TEXT("Antenna 2 gain anomaly") },
+		{ 0x00000100, 0x00000100, SEVERITY_WARNING, OEM7_TEXT("GPS reference time is incorrect") },
+		{ 0x00010000, 0x00010000, SEVERITY_WARNING, OEM7_TEXT("DMI hardware failure") },
+		{ 0x01000000, 0x01000000, SEVERITY_WARNING, OEM7_TEXT("Spoofing calibration failed") },
+		{ 0x02000000, 0x02000000, SEVERITY_WARNING, OEM7_TEXT("Spoofing calibration required") },
+		{ 0x20000000, 0x20000000, SEVERITY_WARNING, OEM7_TEXT("Web content is corrupt or does not exist") },
+		{ 0x40000000, 0x40000000, SEVERITY_WARNING, OEM7_TEXT("RF Calibration Data has an error") },
+		{ 0x80000000, 0x80000000, SEVERITY_INFO, OEM7_TEXT("RF Calibration Data is exists and has no errors") }
+	};
+
+	constexpr StatusBit aux4Bits[] = {
+		{ 0x00000001, 0x00000001, SEVERITY_WARNING, OEM7_TEXT("< 60% of available satellites are tracked well") },
+		{ 0x00000002, 0x00000002, SEVERITY_WARNING, OEM7_TEXT("< 15% of available satellites are tracked well") },
+		{ 0x00001000, 0x00001000, SEVERITY_WARNING, OEM7_TEXT("Clock freewheeling due to bad position integrity") },
+		{ 0x00004000, 0x00004000, SEVERITY_WARNING, OEM7_TEXT("< 60% of expected corrections available") },
+		{ 0x00008000, 0x00008000, SEVERITY_WARNING, OEM7_TEXT("< 15% of expected corrections available") },
+		{ 0x00010000, 0x00010000, SEVERITY_WARNING, OEM7_TEXT("Bad RTK Geometry") },
+		{ 0x00080000, 0x00080000, SEVERITY_WARNING, OEM7_TEXT("Long RTK Baseline >50 km") },
+		{ 0x00100000, 0x00100000, SEVERITY_WARNING, OEM7_TEXT("Poor RTK COM Link corrections quality <= 60%") },
+		{ 0x00200000, 0x00200000, SEVERITY_WARNING, OEM7_TEXT("Poor ALIGN COM Link corrections quality <= 60%") },
+		{ 0x00400000, 0x00400000, SEVERITY_INFO, OEM7_TEXT("GLIDE Not Active") },
+		{ 0x00800000, 0x00800000, SEVERITY_WARNING, OEM7_TEXT("Bad PDP Geometry") },
+		{ 0x01000000, 0x01000000, SEVERITY_INFO, OEM7_TEXT("No TerraStar Subscription") },
+		{ 0x10000000, 0x10000000, SEVERITY_WARNING, OEM7_TEXT("Bad PPP Geometry") },
+		{ 0x40000000, 0x40000000, SEVERITY_INFO, OEM7_TEXT("No INS Alignment") },
+		{ 0x80000000, 0x80000000, SEVERITY_INFO, OEM7_TEXT("INS not converged") }
+	};
+
+	/// \brief Descriptors of one status word
+	struct Table {
+		const StatusBit* bits;
+		size_t count;
+		const char* name;
+		uint32_t known;		// Mask of described bits: changes of other bits are not reported
+	};
+
+	template <size_t N>
+	constexpr Table table(const StatusBit (&bits)[N], const char* name)
+	{
+		uint32_t known = 0;
+		for (size_t i = 0; i < N; ++i) known |= bits[i].mask;
+		return Table{ &bits[0], N, name, known };
+	}
+
+	// Indexed by status word
+	constexpr Table tables[oem7::WORD_AUX4 + 1] = {
+		table(errorBits, "#ERROR"),
+		table(statusBits, "#STATUS"),
+		table(aux1Bits, "#AUX1"),
+		table(aux2Bits, "#AUX2"),
+		table(aux3Bits, "#AUX3"),
+		table(aux4Bits, "#AUX4")
+	};
+	static_assert(tables[oem7::WORD_STATUS].known == 0xFFFFFBFF, "Status word descriptors");
+
+	/// \return Single bit descriptor, otherwise field value
+	constexpr bool single(const StatusBit& bit)
+	{
+		return (bit.mask & (bit.mask - 1)) == 0;
+	}
+
+	uint32_t word(const oem7::RxStatus& status, const uint8_t word)
+	{
+		switch (word) {
+		case oem7::WORD_ERROR: return status.error;
+		case oem7::WORD_STATUS: return status.rxstat;
+		case oem7::WORD_AUX1: return status.aux1stat;
+		case oem7::WORD_AUX2: return status.aux2stat;
+		case oem7::WORD_AUX3: return status.aux3stat;
+		case oem7::WORD_AUX4: return status.aux4stat;
+		}
+		return 0;
+	}
+}
+
+size_t oem7::Diagnostics::update(const RxStatus& status, StatusHandler fn, void* context)
+{
+	size_t reported = 0;
+	for (uint8_t w = WORD_ERROR; w <= WORD_AUX4; ++w) {
+		const uint32_t value = word(status, w);
+		const uint32_t changed = (_words[w] ^ value) & tables[w].known;
+		_words[w] = value;
+		if (changed == 0) continue;
+		const Table& t = tables[w];
+		for (size_t i = 0; i < t.count; ++i) {
+			const StatusBit& bit = t.bits[i];
+			if (!(changed & bit.mask)) continue;
+			// Field reports its new value only
+			const bool set = (value & bit.mask) == bit.value;
+			if (!set && !single(bit)) continue;
+			++reported;
+			if (fn == nullptr) continue;
+			StatusChange change;
+			change.word = w;
+			change.set = set;
+			change.severity = bit.severity;
+			change.mask = bit.mask;
+			change.name = t.name;
+			change.text = bit.text;
+			fn(change, context);
+		}
+	}
+	return reported;
+}
+
+oem7::Severity oem7::Diagnostics::severity() const
+{
+	Severity result = SEVERITY_INFO;
+	for (uint8_t w = WORD_ERROR; w <= WORD_AUX4; ++w) {
+		const Table& t = tables[w];
+		for (size_t i = 0; i < t.count; ++i) {
+			const StatusBit& bit = t.bits[i];
+			if (bit.severity > result && (_words[w] & bit.mask) == bit.value) result = bit.severity;
+		}
+	}
+	return result;
+}
+
+const char* oem7::Diagnostics::name(const uint8_t word)
+{
+	return word <= WORD_AUX4 ? tables[word].name : "";
+}
@@ -0,0 +1,83 @@
+/// \file       Diagnostics.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_DIAGNOSTICS_H__
+#define __OEM7_DIAGNOSTICS_H__
+
+#include "oem7.h"
+#include <stddef.h>
+
+/// \def OEM7_STATUS_TEXT
+/// \brief Descriptions of status bits (1) or empty strings (0), saves about 3 KB of flash
+/// \details Severity and \c StatusChange::mask are kept. Declare in build flags to override
+#ifndef OEM7_STATUS_TEXT
+# define OEM7_STATUS_TEXT 1
+#endif
+
+namespace oem7 {
+    /// \brief Status bit severity
+    /// \ingroup oem7rec
+    enum Severity : uint8_t {
+        SEVERITY_INFO       = 0,    ///< Information
+        SEVERITY_WARNING    = 1,    ///< Degraded, solution may still be used
+        SEVERITY_ERROR      = 2     ///< Antenna, RTK or receiver problem: no valid solution
+    };
+    /// \struct oem7::StatusBit Diagnostics.h
+    /// \brief Descriptor of status bit or multi-bit field value
+    /// \details Single bit descriptor has \c value equal to \c mask, descriptor of several bits describes one value of the field
+    /// \ingroup oem7rec
+    struct StatusBit {
+        uint32_t mask;          ///< Bit or field mask
+        uint32_t value;         ///< Bit or field value
+        Severity severity;      ///< Severity
+        const char* text;       ///< Description
+    };
+    /// \struct oem7::StatusChange Diagnostics.h
+    /// \brief Status transition
+    /// \ingroup oem7rec
+    struct StatusChange {
+        uint8_t word;           ///< Status word (See: \b Status \b Word enumerator)
+        bool set;               ///< Bit is set or field takes the value, \c false - bit is cleared
+        Severity severity;      ///< Severity of the bit or field value
+        uint32_t mask;          ///< Bit or field mask
+        const char* name;       ///< Status word name
+        const char* text;       ///< Description
+    };
+    /// \brief Status transition handler
+    /// \param change Status transition
+    /// \param context User context passed at registration
+    typedef void (*StatusHandler)(const StatusChange& change, void* context);
+
+    /// \class oem7::Diagnostics Diagnostics.h
+    /// \brief Receiver status transitions
+    /// \details Keeps previous status words and reports only changed bits and fields (\c old ^ \c new),
+    /// \details described by constexpr tables of documented bits with severity. Unchanged status costs six XORs
+    /// \details See: https://docs.novatel.com/OEM7/Content/Logs/RXSTATUS.htm
+    /// \ingroup oem7rec
+    class Diagnostics {
+    public:
+        /// \brief Constructor
+        Diagnostics() {}
+    public:
+        /// \brief Report transitions since the previous status
+        /// \details First status after construction or \c reset() reports every set bit
+        /// \param status Receiver status
+        /// \param fn Transition handler (may be \c nullptr)
+        /// \param context User context
+        /// \return Number of reported transitions
+        size_t update(const RxStatus& status, StatusHandler fn, void* context);
+        /// \brief Forget previous status
+        inline void reset() { for (uint32_t& word : _words) word = 0; }
+        /// \return The highest severity of the current status bits and fields
+        Severity severity() const;
+        /// \param word Status word (See: \b Status \b Word enumerator)
+        /// \return Status word name
+        static const char* name(const uint8_t word);
+    private:
+        uint32_t _words[WORD_AUX4 + 1]{};
+    };
+}
+
+#endif // __OEM7_DIAGNOSTICS_H__
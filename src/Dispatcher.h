@@ -0,0 +1,118 @@
+/// \file       Dispatcher.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_DISPATCHER_H__
+#define __OEM7_DISPATCHER_H__
+
+#include "Message.h"
+
+/// \def OEM7_HANDLERS
+/// \brief Capacity of the message handler table
+/// \details Declare in build flags to override
+#ifndef OEM7_HANDLERS
+# define OEM7_HANDLERS 8
+#endif
+
+namespace oem7 {
+    /// \brief Raw message handler
+    /// \param frame Validated frame, valid during the call only
+    /// \param context User context passed at registration
+    typedef void (*MessageHandler)(const Frame& frame, void* context);
+    /// \brief Typed message handler
+    /// \tparam T Message structure
+    /// \param head Message header
+    /// \param msg Message body in the frame buffer, valid during the call only
+    /// \param context User context passed at registration
+    template <typename T>
+    using Handler = void (*)(const Head& head, const T& msg, void* context);
+
+    /// \class oem7::Dispatcher Dispatcher.h
+    /// \brief Fixed-size message handler table
+    /// \details Plain function pointers with user context: no \c std::function and no heap allocation
+    /// \details Handlers are called from \c Receiver::read() (and so from \c Receiver::update()) right after the CRC check
+    /// \ingroup oem7rec
+    class Dispatcher {
+        Dispatcher(const Dispatcher&) = delete;
+        Dispatcher& operator = (const Dispatcher&) = delete;
+    public:
+        /// \brief Constructor
+        Dispatcher() {}
+    public:
+        /// \brief Register raw handler
+        /// \param msgId Message ID
+        /// \param fn Handler
+        /// \param context User context
+        /// \return \c false if table is full
+        inline bool add(const uint16_t msgId, MessageHandler fn, void* context)
+        {
+            return insert(msgId, &invokeRaw, reinterpret_cast<Function>(fn), context);
+        }
+        /// \brief Register typed handler
+        /// \details Handler is called only if message size matches \c sizeof(T)
+        /// \tparam T Message structure
+        /// \param msgId Message ID
+        /// \param fn Handler
+        /// \param context User context
+        /// \return \c false if table is full
+        template <typename T>
+        inline bool add(const uint16_t msgId, Handler<T> fn, void* context)
+        {
+            return insert(msgId, &invokeTyped<T>, reinterpret_cast<Function>(fn), context);
+        }
+        /// \brief Remove all handlers of message
+        /// \param msgId Message ID
+        void remove(const uint16_t msgId)
+        {
+            for (uint8_t i = 0; i < _count;) {
+                if (_table[i].msgId != msgId) {
+                    ++i;
+                    continue;
+                }
+                _table[i] = _table[--_count];
+            }
+        }
+        /// \brief Call handlers of frame
+        /// \param frame Validated frame
+        inline void dispatch(const Frame& frame) const
+        {
+            const uint16_t id = frame.id();
+            for (uint8_t i = 0; i < _count; ++i) {
+                if (_table[i].msgId == id) _table[i].invoke(_table[i], frame);
+            }
+        }
+    private:
+        typedef void (*Function)();
+        struct Entry;
+        typedef void (*Invoke)(const Entry& entry, const Frame& frame);
+        struct Entry {
+            uint16_t msgId;
+            Invoke invoke;
+            Function fn;
+            void* context;
+        };
+    private:
+        inline bool insert(const uint16_t msgId, Invoke invoke, Function fn, void* context)
+        {
+            if (fn == nullptr || _count >= OEM7_HANDLERS) return false;
+            _table[_count++] = Entry{ msgId, invoke, fn, context };
+            return true;
+        }
+        static void invokeRaw(const Entry& entry, const Frame& frame)
+        {
+            reinterpret_cast<MessageHandler>(entry.fn)(frame, entry.context);
+        }
+        template <typename T>
+        static void invokeTyped(const Entry& entry, const Frame& frame)
+        {
+            const MessageView<T> view(frame, entry.msgId);
+            if (view) reinterpret_cast<Handler<T>>(entry.fn)(view.head(), *view, entry.context);
+        }
+    private:
+        uint8_t _count{ 0 };
+        Entry _table[OEM7_HANDLERS]{};
+    };
+}
+
+#endif // __OEM7_DISPATCHER_H__
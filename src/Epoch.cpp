@@ -0,0 +1,96 @@
+/// \file       Epoch.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Epoch.h"
+
+void oem7::EpochMatcher::require(const uint8_t logs)
+{
+	_required = logs & (EPOCH_POSITION | EPOCH_HEADING);
+	for (Epoch& epoch : _epochs) epoch.logs = 0;
+	_last = 0;
+	_pending = false;
+}
+
+void oem7::EpochMatcher::add(const Frame& frame)
+{
+	const MessageView<BestPos> pos(frame, MSG_BESTPOS);
+	const MessageView<DualAntHeading> hdg(frame, MSG_DUALANTHEADING);
+	const uint8_t log = pos ? EPOCH_POSITION : hdg ? EPOCH_HEADING : 0;
+	if (!(log & _required)) return;
+	Epoch late;
+	late.week = frame.head->week;
+	late.ms = frame.head->ms;
+	const uint64_t key = late.key();
+	// Epoch is complete or given up already
+	Epoch& epoch = key <= _last ? late : slot(late.week, late.ms);
+	epoch.logs |= log;
+	if (pos) epoch.position = *pos;
+	else epoch.heading = *hdg;
+	if (&epoch == &late) {
+		drop(late);
+		return;
+	}
+	if ((epoch.logs & _required) != _required) return;
+	// Complete: older epochs will not complete any more
+	for (Epoch& older : _epochs) {
+		if (older.logs != 0 && older.key() < key) drop(older);
+	}
+	if (_pending) {
+		++_superseded;
+		report(_latest, EPOCH_SUPERSEDED);
+	}
+	++_complete;
+	_latest = epoch;
+	_pending = true;
+	_last = key;
+	epoch.logs = 0;
+}
+
+const oem7::Epoch* oem7::EpochMatcher::flush()
+{
+	if (!_pending) return nullptr;
+	_pending = false;
+	report(_latest, EPOCH_COMPLETE);
+	return &_latest;
+}
+
+oem7::Epoch& oem7::EpochMatcher::slot(const uint16_t week, const uint32_t ms)
+{
+	Epoch probe;
+	probe.week = week;
+	probe.ms = ms;
+	const uint64_t key = probe.key();
+	Epoch* free = nullptr;
+	Epoch* oldest = nullptr;
+	for (Epoch& epoch : _epochs) {
+		if (epoch.logs == 0) {
+			if (free == nullptr) free = &epoch;
+			continue;
+		}
+		if (epoch.key() == key) return epoch;
+		if (oldest == nullptr || epoch.key() < oldest->key()) oldest = &epoch;
+	}
+	if (free == nullptr) {
+		// Buffer is full: the oldest epoch is given up
+		drop(*oldest);
+		free = oldest;
+	}
+	free->week = week;
+	free->ms = ms;
+	free->logs = 0;
+	return *free;
+}
+
+void oem7::EpochMatcher::drop(Epoch& epoch)
+{
+	++_incomplete;
+	report(epoch, EPOCH_INCOMPLETE);
+	epoch.logs = 0;
+}
+
+void oem7::EpochMatcher::report(const Epoch& epoch, const EpochStatus status)
+{
+	if (_fn != nullptr) _fn(epoch, status, _context);
+}
@@ -0,0 +1,105 @@
+/// \file       Epoch.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_EPOCH_H__
+#define __OEM7_EPOCH_H__
+
+#include "Message.h"
+
+/// \def OEM7_EPOCHS
+/// \brief Number of epochs waiting for their position or heading
+/// \details Declare in build flags to override
+#ifndef OEM7_EPOCHS
+# define OEM7_EPOCHS 4
+#endif
+
+namespace oem7 {
+    /// \brief Epoch outcome
+    /// \ingroup oem7rec
+    enum EpochStatus : uint8_t {
+        EPOCH_COMPLETE      = 0,    ///< All required logs of the epoch, the latest complete epoch of \c Receiver::update()
+        EPOCH_SUPERSEDED    = 1,    ///< All required logs, but a newer epoch completed in the same \c Receiver::update()
+        EPOCH_INCOMPLETE    = 2     ///< Given up: a newer epoch completed, buffer is full or the log came too late
+    };
+    /// \brief Logs of epoch
+    /// \ingroup oem7rec
+    enum {
+        EPOCH_POSITION      = 0x01, ///< \c BESTPOS
+        EPOCH_HEADING       = 0x02  ///< \c DUALANTENNAHEADING
+    };
+    /// \struct oem7::Epoch Epoch.h
+    /// \brief Position and heading of one GPS epoch
+    /// \ingroup oem7rec
+    struct Epoch {
+        uint16_t week{ 0 };         ///< GPS reference week
+        uint32_t ms{ 0 };           ///< Milliseconds of the GPS reference week
+        uint8_t logs{ 0 };          ///< Received logs (\c EPOCH_POSITION, \c EPOCH_HEADING)
+        BestPos position{};         ///< Position, valid with \c EPOCH_POSITION
+        DualAntHeading heading{};   ///< Heading, valid with \c EPOCH_HEADING
+        /// \return Epoch key: milliseconds since GPS time start
+        inline uint64_t key() const { return static_cast<uint64_t>(week) * 604800000u + ms; }
+    };
+    /// \brief Epoch handler
+    /// \param epoch Epoch, valid during the call only
+    /// \param status Outcome
+    /// \param context User context passed at registration
+    typedef void (*EpochHandler)(const Epoch& epoch, const EpochStatus status, void* context);
+
+    /// \class oem7::EpochMatcher Epoch.h
+    /// \brief Pairs \c BESTPOS and \c DUALANTENNAHEADING by the GPS epoch of their headers
+    /// \details Fixed buffer of \c OEM7_EPOCHS epochs. An epoch is complete when all required logs arrived, then older
+    /// \details epochs are given up: the receiver outputs logs in epoch order. The latest complete epoch is held until
+    /// \details \c flush(), so a burst of several epochs reports the earlier ones as superseded, none is lost
+    /// \ingroup oem7rec
+    class EpochMatcher {
+        EpochMatcher(const EpochMatcher&) = delete;
+        EpochMatcher& operator = (const EpochMatcher&) = delete;
+    public:
+        /// \brief Constructor
+        EpochMatcher() {}
+    public:
+        /// \brief Set required logs and forget waiting epochs
+        /// \param logs Required logs (\c EPOCH_POSITION, \c EPOCH_HEADING), 0 - no matching
+        void require(const uint8_t logs);
+        /// \brief Set epoch handler
+        /// \param fn Handler or \c nullptr to remove
+        /// \param context User context passed to handler
+        inline void onEpoch(EpochHandler fn, void* context = nullptr) { _fn = fn; _context = context; }
+        /// \brief Add log
+        /// \param frame Validated frame, other logs are ignored
+        void add(const Frame& frame);
+        /// \brief Report the latest complete epoch
+        /// \details Called by \c Receiver::update() after the messages are drained
+        /// \return Epoch completed since the previous call or \c nullptr
+        const Epoch* flush();
+    public:
+        /// \return Number of complete epochs
+        inline uint32_t complete() const { return _complete; }
+        /// \return Number of complete epochs superseded by a newer one before \c flush()
+        inline uint32_t superseded() const { return _superseded; }
+        /// \return Number of incomplete epochs
+        inline uint32_t incomplete() const { return _incomplete; }
+    private:
+        /// \brief Slot of epoch, a free or the oldest one is taken for a new epoch
+        Epoch& slot(const uint16_t week, const uint32_t ms);
+        /// \brief Give up epoch
+        void drop(Epoch& epoch);
+        /// \brief Pass epoch to handler
+        void report(const Epoch& epoch, const EpochStatus status);
+    private:
+        Epoch _epochs[OEM7_EPOCHS];
+        Epoch _latest;
+        uint64_t _last{ 0 };
+        bool _pending{ false };
+        uint8_t _required{ EPOCH_POSITION | EPOCH_HEADING };
+        EpochHandler _fn{ nullptr };
+        void* _context{ nullptr };
+        uint32_t _complete{ 0 };
+        uint32_t _superseded{ 0 };
+        uint32_t _incomplete{ 0 };
+    };
+}
+
+#endif // __OEM7_EPOCH_H__
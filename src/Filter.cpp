@@ -0,0 +1,171 @@
+/// \file       Filter.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Filter.h"
+#include <math.h>
+
+namespace {
+	/// \brief Metres of one degree of latitude
+	constexpr double METRES_PER_DEGREE = 111320.0;
+	constexpr double DEG_TO_RAD = 0.017453292519943295;
+	/// \brief The smallest standard deviation of measurement: solution with zero deviation is not exact
+	constexpr double MIN_DEV = 0.001;
+	/// \brief Standard deviation of the unknown rate at start: speed (m/s) and turn rate (deg/s)
+	constexpr double START_SPEED = 10.0;
+	constexpr double START_TURN = 30.0;
+
+	double wrap360(double deg)
+	{
+		deg = fmod(deg, 360.0);
+		return deg < 0 ? deg + 360.0 : deg;
+	}
+
+	double wrap180(double deg)
+	{
+		deg = wrap360(deg + 180.0);
+		return deg - 180.0;
+	}
+
+	double square(const double value)
+	{
+		return value * value;
+	}
+
+	double variance(const float dev, const double scale)
+	{
+		const double d = dev > MIN_DEV ? dev : MIN_DEV;
+		return square(d / scale);
+	}
+
+	/// \return Elapsed time (s), 0 if \c now is before \c time
+	double elapsed(const uint32_t now, const uint32_t time)
+	{
+		const int32_t us = static_cast<int32_t>(now - time);
+		return us > 0 ? us * 1e-6 : 0.0;
+	}
+
+	bool stale(const uint32_t now, const uint32_t time)
+	{
+		return static_cast<int32_t>(now - time) > static_cast<int32_t>(OEM7_FILTER_HORIZON) * 1000;
+	}
+
+	/// \return Metres of one degree of longitude
+	double metresLon(const double lat)
+	{
+		const double m = METRES_PER_DEGREE * cos(lat * DEG_TO_RAD);
+		return m > 1.0 ? m : 1.0;
+	}
+}
+
+void oem7::SolutionFilter::Axis::init(const double z, const double r, const double rv)
+{
+	x = z;
+	v = 0;
+	p00 = r;
+	p01 = 0;
+	p11 = rv;
+}
+
+void oem7::SolutionFilter::Axis::predict(const double dt, const double q)
+{
+	x += v * dt;
+	// P = F P F' + Q, F = [1 dt; 0 1], Q of white acceleration
+	p00 += dt * (2 * p01 + dt * p11) + q * dt * dt * dt / 3;
+	p01 += dt * p11 + q * dt * dt / 2;
+	p11 += q * dt;
+}
+
+void oem7::SolutionFilter::Axis::correct(const double y, const double r)
+{
+	const double s = p00 + r;
+	const double k0 = p00 / s;
+	const double k1 = p01 / s;
+	x += k0 * y;
+	v += k1 * y;
+	p11 -= k1 * p01;
+	p01 *= 1 - k0;
+	p00 *= 1 - k0;
+}
+
+double oem7::SolutionFilter::Axis::variance(const double dt, const double q) const
+{
+	return p00 + dt * (2 * p01 + dt * p11) + q * dt * dt * dt / 3;
+}
+
+void oem7::SolutionFilter::position(const BestPos& pos, const uint32_t time)
+{
+	const double mLon = metresLon(pos.lat);
+	const double qLat = square(OEM7_FILTER_POSITION_NOISE / METRES_PER_DEGREE);
+	const double qLon = square(OEM7_FILTER_POSITION_NOISE / mLon);
+	const double qAlt = square(OEM7_FILTER_POSITION_NOISE);
+	const double rLat = variance(pos.latStdDev, METRES_PER_DEGREE);
+	const double rLon = variance(pos.lonStdDev, mLon);
+	const double rAlt = variance(pos.altStdDev, 1.0);
+	if (!_positionValid || stale(time, _positionTime)) {
+		_lat.init(pos.lat, rLat, square(START_SPEED / METRES_PER_DEGREE));
+		_lon.init(pos.lon, rLon, square(START_SPEED / mLon));
+		_alt.init(pos.alt, rAlt, square(START_SPEED));
+	} else {
+		const double dt = elapsed(time, _positionTime);
+		_lat.predict(dt, qLat);
+		_lon.predict(dt, qLon);
+		_alt.predict(dt, qAlt);
+		_lat.correct(pos.lat - _lat.x, rLat);
+		_lon.correct(wrap180(pos.lon - _lon.x), rLon);
+		_alt.correct(pos.alt - _alt.x, rAlt);
+		_lon.x = wrap180(_lon.x);
+	}
+	_positionTime = time;
+	_positionValid = true;
+}
+
+void oem7::SolutionFilter::heading(const DualAntHeading& hdg, const uint32_t time)
+{
+	const double q = square(OEM7_FILTER_HEADING_NOISE);
+	const double r = variance(hdg.hdgStdDev, 1.0);
+	if (!_headingValid || stale(time, _headingTime)) {
+		_hdg.init(hdg.heading, r, square(START_TURN));
+	} else {
+		_hdg.predict(elapsed(time, _headingTime), q);
+		// Shortest way around 0/360
+		_hdg.correct(wrap180(hdg.heading - _hdg.x), r);
+		_hdg.x = wrap360(_hdg.x);
+	}
+	_headingTime = time;
+	_headingValid = true;
+}
+
+oem7::Estimate oem7::SolutionFilter::estimate(const uint32_t now) const
+{
+	Estimate result;
+	result.time = now;
+	if (_positionValid && !stale(now, _positionTime)) {
+		const double dt = elapsed(now, _positionTime);
+		const double mLon = metresLon(_lat.x);
+		result.lat = _lat.x + _lat.v * dt;
+		result.lon = wrap180(_lon.x + _lon.v * dt);
+		result.alt = _alt.x + _alt.v * dt;
+		result.latDev = static_cast<float>(sqrt(_lat.variance(dt, square(OEM7_FILTER_POSITION_NOISE / METRES_PER_DEGREE))) * METRES_PER_DEGREE);
+		result.lonDev = static_cast<float>(sqrt(_lon.variance(dt, square(OEM7_FILTER_POSITION_NOISE / mLon))) * mLon);
+		result.altDev = static_cast<float>(sqrt(_alt.variance(dt, square(OEM7_FILTER_POSITION_NOISE))));
+		result.north = static_cast<float>(_lat.v * METRES_PER_DEGREE);
+		result.east = static_cast<float>(_lon.v * mLon);
+		result.positionValid = true;
+	}
+	if (_headingValid && !stale(now, _headingTime)) {
+		const double dt = elapsed(now, _headingTime);
+		result.heading = static_cast<float>(wrap360(_hdg.x + _hdg.v * dt));
+		result.headingDev = static_cast<float>(sqrt(_hdg.variance(dt, square(OEM7_FILTER_HEADING_NOISE))));
+		result.headingRate = static_cast<float>(_hdg.v);
+		result.headingValid = true;
+	}
+	return result;
+}
+
+void oem7::SolutionFilter::reset()
+{
+	_positionValid = false;
+	_headingValid = false;
+}
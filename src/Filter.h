@@ -0,0 +1,107 @@
+/// \file       Filter.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_FILTER_H__
+#define __OEM7_FILTER_H__
+
+#include "oem7.h"
+
+/// \def OEM7_FILTER_HEADING_NOISE
+/// \brief Heading process noise: angular acceleration (deg/s^2)
+/// \details Larger values follow turns faster, smaller values smooth more. Declare in build flags to override
+#ifndef OEM7_FILTER_HEADING_NOISE
+# define OEM7_FILTER_HEADING_NOISE 10.0
+#endif
+/// \def OEM7_FILTER_POSITION_NOISE
+/// \brief Position process noise: acceleration (m/s^2)
+#ifndef OEM7_FILTER_POSITION_NOISE
+# define OEM7_FILTER_POSITION_NOISE 1.0
+#endif
+/// \def OEM7_FILTER_HORIZON
+/// \brief Longest prediction (in ms): older solutions are not extrapolated and restart the filter
+#ifndef OEM7_FILTER_HORIZON
+# define OEM7_FILTER_HORIZON 1000
+#endif
+
+namespace oem7 {
+    /// \struct oem7::Estimate Filter.h
+    /// \brief Filtered and predicted position and heading
+    /// \ingroup oem7rec
+    struct Estimate {
+        uint32_t time{ 0 };             ///< Host monotonic time of estimate (us)
+        double lat{ 0 };                ///< Latitude (degrees)
+        double lon{ 0 };                ///< Longitude (degrees)
+        double alt{ 0 };                ///< Height above mean sea level (metres)
+        float latDev{ 0 };              ///< Latitude standard deviation (m)
+        float lonDev{ 0 };              ///< Longitude standard deviation (m)
+        float altDev{ 0 };              ///< Height standard deviation (m)
+        float north{ 0 };               ///< North velocity (m/s)
+        float east{ 0 };                ///< East velocity (m/s)
+        float heading{ 0 };             ///< Heading in degrees (0 to 359.999 degrees)
+        float headingDev{ 0 };          ///< Heading standard deviation in degrees
+        float headingRate{ 0 };         ///< Turn rate (deg/s)
+        bool positionValid{ false };    ///< Position solution within \c OEM7_FILTER_HORIZON
+        bool headingValid{ false };     ///< Heading solution within \c OEM7_FILTER_HORIZON
+    };
+
+    /// \class oem7::SolutionFilter Filter.h
+    /// \brief Constant velocity Kalman filter of position and heading
+    /// \details Each axis (latitude, longitude, height, heading) is a two-state filter: value and rate.
+    /// \details Measurement noise is the standard deviation of the solution, heading innovation is wrapped to +/-180 degrees.
+    /// \details Fixed size, no allocation. Solutions are timestamped by the host receive time, so the estimate
+    /// \details lags real time by the link latency
+    /// \ingroup oem7rec
+    class SolutionFilter {
+    public:
+        /// \brief Constructor
+        SolutionFilter() {}
+    public:
+        /// \brief Update by position
+        /// \param pos Computed position
+        /// \param time Host monotonic receive time (us)
+        void position(const BestPos& pos, const uint32_t time);
+        /// \brief Update by heading
+        /// \param hdg Computed heading
+        /// \param time Host monotonic receive time (us)
+        void heading(const DualAntHeading& hdg, const uint32_t time);
+        /// \brief Predict
+        /// \param now Host monotonic time (us)
+        /// \return Estimate at \c now
+        Estimate estimate(const uint32_t now) const;
+        /// \brief Forget solutions
+        void reset();
+    private:
+        /// \brief Value and rate of one axis
+        struct Axis {
+            double x{ 0 };          ///< Value
+            double v{ 0 };          ///< Rate
+            double p00{ 0 };        ///< Value variance
+            double p01{ 0 };        ///< Value and rate covariance
+            double p11{ 0 };        ///< Rate variance
+            /// \brief Start from measurement
+            /// \param z Measurement
+            /// \param r Measurement variance
+            /// \param rv Rate variance
+            void init(const double z, const double r, const double rv);
+            /// \brief Propagate state
+            void predict(const double dt, const double q);
+            /// \brief Correct by innovation
+            void correct(const double y, const double r);
+            /// \return Value variance after \c dt
+            double variance(const double dt, const double q) const;
+        };
+    private:
+        Axis _lat;
+        Axis _lon;
+        Axis _alt;
+        Axis _hdg;
+        uint32_t _positionTime{ 0 };
+        uint32_t _headingTime{ 0 };
+        bool _positionValid{ false };
+        bool _headingValid{ false };
+    };
+}
+
+#endif // __OEM7_FILTER_H__
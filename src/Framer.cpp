@@ -0,0 +1,219 @@
+/// \file       Framer.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Framer.h"
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define OEM7_SYNC_SSE2
+#endif
+
+size_t oem7::Framer::parse(const uint8_t* data, size_t size)
+{
+	_status = FRAME_NONE;
+	// Buffer does not hold a header
+	if (_capacity == 0) {
+		_discarded += size;
+		return size;
+	}
+	// Bytes of a rejected frame are parsed again before new data
+	while (_replayLen > 0) {
+		const size_t n = step(&_buffer[_replayPos], _replayLen);
+		if (_status == FRAME_NONE) {
+			_replayLen = 0;
+			break;
+		}
+		_replayPos += n;
+		_replayLen -= n;
+		if (_status != FRAME_READY) rewind(&_buffer[_replayPos], _replayLen);
+		return 0;
+	}
+	const size_t n = step(data, size);
+	if (_status != FRAME_NONE && _status != FRAME_READY) rewind(nullptr, 0);
+	return n;
+}
+
+void oem7::Framer::reset()
+{
+	_state = STATE_SYNC1;
+	_status = FRAME_NONE;
+	_offset = 0;
+	_need = 0;
+	_replayPos = 0;
+	_replayLen = 0;
+}
+
+const uint8_t* oem7::Framer::find(const uint8_t* data, const uint8_t* end)
+{
+#ifdef OEM7_SYNC_SSE2
+	// 16 candidates per step: AA at i, 44 at i+1 and 12 or 13 at i+2
+	const __m128i s1 = _mm_set1_epi8(static_cast<char>(HEAD_SYNC_1));
+	const __m128i s2 = _mm_set1_epi8(static_cast<char>(HEAD_SYNC_2));
+	const __m128i s3 = _mm_set1_epi8(static_cast<char>(HEAD_SYNC_3));
+	const __m128i s3s = _mm_set1_epi8(static_cast<char>(HEAD_SHORT_SYNC_3));
+	while (end - data >= 18) {
+		const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+		const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 1));
+		const __m128i b3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2));
+		const __m128i m3 = _mm_or_si128(_mm_cmpeq_epi8(b3, s3), _mm_cmpeq_epi8(b3, s3s));
+		const __m128i m = _mm_and_si128(_mm_cmpeq_epi8(b1, s1), _mm_and_si128(_mm_cmpeq_epi8(b2, s2), m3));
+		const int mask = _mm_movemask_epi8(m);
+		if (mask != 0) {
+#if defined(_MSC_VER) && !defined(__clang__)
+			unsigned long idx;
+			_BitScanForward(&idx, static_cast<unsigned long>(mask));
+			return data + idx;
+#else
+			return data + __builtin_ctz(static_cast<unsigned>(mask));
+#endif
+		}
+		data += 16;
+	}
+#endif
+	// Tail (or whole block without SIMD): memchr to Sync Byte 1 and check the rest
+	while (data < end) {
+		const uint8_t* p = static_cast<const uint8_t*>(memchr(data, HEAD_SYNC_1, static_cast<size_t>(end - data)));
+		if (p == nullptr) return end;
+		// Sync split by the end of block is a candidate
+		if (p + 1 == end || (p[1] == HEAD_SYNC_2 && (p + 2 == end || p[2] == HEAD_SYNC_3 || p[2] == HEAD_SHORT_SYNC_3))) return p;
+		data = p + 1;
+	}
+	return end;
+}
+
+size_t oem7::Framer::step(const uint8_t* data, size_t size)
+{
+	const uint8_t* ptr = data;
+	const uint8_t* end = data + size;
+	while (ptr < end) {
+		switch (_state) {
+		case STATE_SYNC1: {
+			// Skip to the next 0xAA 0x44 0x12 (0x13) candidate
+			const uint8_t* sync = find(ptr, end);
+			if (_text != nullptr && sync != ptr) _text(ptr, static_cast<size_t>(sync - ptr), _textContext);
+			_discarded += static_cast<size_t>(sync - ptr);
+			ptr = sync;
+			if (ptr == end) break;
+			_buffer[0] = *ptr++;
+			_offset = 1;
+			_state = STATE_SYNC2;
+			break;
+		}
+		case STATE_SYNC2:
+			// 0x44 Sync Byte. Mismatched byte is examined again as Sync Byte 1
+			if (*ptr != HEAD_SYNC_2) {
+				++_discarded;
+				_state = STATE_SYNC1;
+				break;
+			}
+			_buffer[1] = *ptr++;
+			_offset = 2;
+			_state = STATE_SYNC3;
+			break;
+		case STATE_SYNC3:
+			// 0x12 Sync Byte, 0x13 of short header
+			if (*ptr != HEAD_SYNC_3 && *ptr != HEAD_SHORT_SYNC_3) {
+				_discarded += 2;
+				_state = STATE_SYNC1;
+				break;
+			}
+			_buffer[2] = *ptr++;
+			_offset = 3;
+			if (_buffer[2] == HEAD_SYNC_3) {
+				_state = STATE_HDRLEN;
+				break;
+			}
+			// Short header has no Head Size byte
+			_header = HEAD_SHORT_LENGHT;
+			_crc.reset();
+			_crc.update(&_buffer[0], 3);
+			_need = HEAD_SHORT_LENGHT;
+			_state = STATE_HEADER;
+			break;
+		case STATE_HDRLEN:
+			// 0x1C Head Size
+			_buffer[3] = *ptr++;
+			_offset = 4;
+			_state = STATE_SYNC1;
+			if (_buffer[3] != HEAD_LENGHT) {
+				_status = FRAME_HEAD_SIZE;
+				return static_cast<size_t>(ptr - data);
+			}
+			_header = HEAD_LENGHT;
+			_crc.reset();
+			_crc.update(&_buffer[0], 4);
+			_need = HEAD_LENGHT;
+			_state = STATE_HEADER;
+			break;
+		case STATE_HEADER:
+			ptr += fill(ptr, static_cast<size_t>(end - ptr));
+			if (_offset < _need) break;
+			if (_header == HEAD_SHORT_LENGHT) expand();
+			else memcpy(&_head, &_buffer[4], sizeof(Head));
+			_need = _header + static_cast<size_t>(_head.msgLenght);
+			if (_need + sizeof(uint32_t) > _capacity) {
+				_state = STATE_SYNC1;
+				_status = FRAME_OVERSIZE;
+				return static_cast<size_t>(ptr - data);
+			}
+			_state = STATE_BODY;
+			break;
+		case STATE_BODY:
+			ptr += fill(ptr, static_cast<size_t>(end - ptr));
+			if (_offset < _need) break;
+			_need += sizeof(uint32_t);
+			_state = STATE_CRC;
+			break;
+		case STATE_CRC: {
+			// CRC bytes are stored after the body but not accumulated
+			const size_t n = (_need - _offset) < static_cast<size_t>(end - ptr) ? (_need - _offset) : static_cast<size_t>(end - ptr);
+			memmove(&_buffer[_offset], ptr, n);
+			_offset += n;
+			ptr += n;
+			if (_offset < _need) break;
+			memcpy(&_received, &_buffer[_need - sizeof(uint32_t)], sizeof(uint32_t));
+			_state = STATE_SYNC1;
+			_status = (_received == _crc.value()) ? FRAME_READY : FRAME_CRC;
+			return static_cast<size_t>(ptr - data);
+		}
+		}
+	}
+	return size;
+}
+
+void oem7::Framer::expand()
+{
+	ShortHead head;
+	memcpy(&head, &_buffer[3], sizeof(ShortHead));
+	_head = Head{};
+	_head.msgId = head.msgId;
+	_head.msgLenght = head.msgLenght;
+	_head.timeStatus = GPSTIME_UNKNOWN;
+	_head.week = head.week;
+	_head.ms = head.ms;
+}
+
+size_t oem7::Framer::fill(const uint8_t* data, size_t size)
+{
+	const size_t n = (_need - _offset) < size ? (_need - _offset) : size;
+	// Source may be a replayed part of the buffer itself
+	memmove(&_buffer[_offset], data, n);
+	_crc.update(&_buffer[_offset], n);
+	_offset += n;
+	return n;
+}
+
+void oem7::Framer::rewind(const uint8_t* tail, size_t size)
+{
+	// Rejected frame: restart the sync search from the byte after the bad sync.
+	// Replayed bytes are always written at or before their own position, so the
+	// unparsed tail of a previous replay can be joined right after the frame bytes
+	if (size > 0) memmove(&_buffer[_offset], tail, size);
+	++_discarded;
+	_replayPos = 1;
+	_replayLen = _offset - 1 + size;
+	_offset = 0;
+}
@@ -0,0 +1,152 @@
+/// \file       Framer.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_FRAMER_H__
+#define __OEM7_FRAMER_H__
+
+#include "oem7.h"
+#include "Crc32.h"
+#include "Message.h"
+
+/// \def OEM7_FRAME_SIZE
+/// \brief Size of the frame buffer embedded in each oem7::Receiver: header, body and CRC (in bytes)
+/// \details Declare in build flags to override. 0 - no embedded buffer, storage must be passed to the constructor
+#ifndef OEM7_FRAME_SIZE
+# define OEM7_FRAME_SIZE 1024
+#endif
+/// \def OEM7_FRAME_FIT
+/// \brief Size the embedded frame buffer to the longest enabled log or command response instead of \c OEM7_FRAME_SIZE
+/// \details Longer frames of other logs are dropped as oversize. Declare in build flags to override
+#ifndef OEM7_FRAME_FIT
+# define OEM7_FRAME_FIT 0
+#endif
+
+namespace oem7 {
+    /// \brief Handler of bytes received outside binary frames
+    /// \details Used for abbreviated ASCII command replies
+    /// \param data Bytes, valid during the call only
+    /// \param size Number of bytes
+    /// \param context User context passed at registration
+    typedef void (*TextHandler)(const uint8_t* data, size_t size, void* context);
+
+    /// \class oem7::Framer Framer.h
+    /// \brief Resumable OEM7 binary frame parser
+    /// \details Non-blocking state machine \c SYNC1 - \c SYNC2 - \c SYNC3 - \c HDRLEN - \c HEADER - \c BODY - \c CRC
+    /// \details Long (\c 0xAA \c 0x44 \c 0x12) and short (\c 0xAA \c 0x44 \c 0x13, no \c HDRLEN) headers are accepted,
+    /// \details the short one is expanded into oem7::Head, see oem7::Frame
+    /// \details Accepts any number of bytes per call and keeps partial frames between calls
+    /// \details CRC is accumulated while bytes stream in
+    /// \details Sync search scans whole blocks (\c memchr, SSE2 on x86). A rejected frame is
+    /// \details searched again from the byte after its sync, so a frame hidden inside it is not lost
+    /// \details Works over caller storage: each instance is independent and has no shared state
+    /// \details See: https://docs.novatel.com/OEM7/Content/Messages/Binary.htm
+    /// \ingroup oem7rec
+    class Framer {
+        Framer() = delete;
+        Framer(const Framer&) = delete;
+        Framer& operator = (const Framer&) = delete;
+    public:
+        /// \brief Parse status
+        enum Status : uint8_t {
+            FRAME_NONE      = 0,    ///< Frame is incomplete, more bytes needed
+            FRAME_READY     = 1,    ///< Frame is complete and CRC is valid
+            FRAME_HEAD_SIZE = 2,    ///< Unsupported header length
+            FRAME_OVERSIZE  = 3,    ///< Frame does not fit into the buffer
+            FRAME_CRC       = 4     ///< CRC mismatch
+        };
+    public:
+        /// \brief The smallest frame buffer: long header and CRC (in bytes)
+        static constexpr size_t MIN_SIZE = HEAD_LENGHT + sizeof(uint32_t);
+    public:
+        /// \brief Constructor
+        /// \details A buffer smaller than \c MIN_SIZE is not used: \c capacity() is 0 and all bytes are discarded
+        /// \param buffer Frame buffer
+        /// \param size Frame buffer size: header, body and CRC (in bytes), at least \c MIN_SIZE. Longer frames are rejected
+        Framer(uint8_t* buffer, const size_t size) : _buffer(buffer), _capacity(size >= MIN_SIZE ? size : 0) {}
+    public:
+        /// \brief Parse incoming bytes
+        /// \details Stops right after a complete frame or an error, check \c status() and call again with the rest bytes
+        /// \details Frame data is valid until the next call
+        /// \param data Received bytes
+        /// \param size Number of received bytes
+        /// \return Number of bytes consumed
+        size_t parse(const uint8_t* data, size_t size);
+        /// \brief Drop partial frame and wait for sync
+        void reset();
+        /// \brief Register handler of bytes skipped while searching for sync
+        /// \param fn Handler (\c nullptr - skipped bytes are dropped)
+        /// \param context User context
+        inline void onText(TextHandler fn, void* context) { _text = fn; _textContext = context; }
+        /// \return Status of the last \c parse() call
+        inline Status status() const { return _status; }
+        /// \return Header of the complete frame
+        inline const Head& head() const { return _head; }
+        /// \return Body of the complete frame
+        inline const uint8_t* body() const { return &_buffer[_header]; }
+        /// \return Body size of the complete frame (in bytes)
+        inline size_t size() const { return _head.msgLenght; }
+        /// \return Complete frame
+        inline Frame frame() const { Frame f; f.head = &_head; f.body = body(); f.size = size(); f.header = _header; return f; }
+        /// \return Header length of the last frame: \c HEAD_LENGHT or \c HEAD_SHORT_LENGHT
+        inline uint8_t header() const { return _header; }
+        /// \return CRC read from the frame
+        inline uint32_t crc() const { return _received; }
+        /// \return CRC computed over the frame
+        inline uint32_t computed() const { return _crc.value(); }
+        /// \return Bytes of a rejected frame are waiting to be parsed again: call \c parse() even without new data
+        inline bool pending() const { return _replayLen > 0; }
+        /// \return Frame buffer size
+        inline size_t capacity() const { return _capacity; }
+        /// \return Number of bytes skipped while searching for sync
+        inline size_t discarded() const { return _discarded; }
+    public:
+        /// \brief Find sync candidate
+        /// \param data Block begin
+        /// \param end Block end
+        /// \return Pointer to the first \c 0xAA \c 0x44 \c 0x12 or \c 0x13 (or its beginning split by the block end) or \c end
+        static const uint8_t* find(const uint8_t* data, const uint8_t* end);
+    private:
+        /// \brief Run the state machine over bytes
+        /// \return Number of bytes consumed
+        size_t step(const uint8_t* data, size_t size);
+        /// \brief Expand short header of the frame buffer into \c _head
+        void expand();
+        /// \brief Copy bytes into the frame buffer up to \c _need and accumulate CRC
+        /// \return Number of bytes copied
+        size_t fill(const uint8_t* data, size_t size);
+        /// \brief Schedule bytes of the rejected frame to be parsed again
+        /// \param tail Unparsed rest of the previous replay
+        /// \param size Size of the rest
+        void rewind(const uint8_t* tail, size_t size);
+    private:
+        /// \brief Parser State
+        enum State : uint8_t {
+            STATE_SYNC1,
+            STATE_SYNC2,
+            STATE_SYNC3,
+            STATE_HDRLEN,
+            STATE_HEADER,
+            STATE_BODY,
+            STATE_CRC
+        };
+        State _state{ STATE_SYNC1 };
+        Status _status{ FRAME_NONE };
+        uint8_t _header{ HEAD_LENGHT };
+        size_t _offset{ 0 };
+        size_t _need{ 0 };
+        size_t _replayPos{ 0 };
+        size_t _replayLen{ 0 };
+        size_t _discarded{ 0 };
+        uint32_t _received{ 0 };
+        TextHandler _text{ nullptr };
+        void* _textContext{ nullptr };
+        Crc32 _crc;
+        Head _head{};
+        uint8_t* const _buffer;
+        const size_t _capacity;
+    };
+}
+
+#endif // __OEM7_FRAMER_H__
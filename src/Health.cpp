@@ -0,0 +1,80 @@
+/// \file       Health.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Health.h"
+
+static_assert(OEM7_HEALTH_SAMPLES > 0 && OEM7_HEALTH_SAMPLES <= 255, "OEM7_HEALTH_SAMPLES is 1 to 255");
+
+oem7::Severity oem7::HealthSensor::severity() const
+{
+	switch (_change.to) {
+	case BOUNDARY_ACCEPT: return SEVERITY_INFO;
+	case BOUNDARY_LOW_WARNING:
+	case BOUNDARY_UP_WARNING: return SEVERITY_WARNING;
+	}
+	return SEVERITY_ERROR;
+}
+
+bool oem7::HealthSensor::add(const Head& head, const HWMonitor& reading, const uint32_t received)
+{
+	_samples[_next] = reading.value;
+	_next = static_cast<uint8_t>((_next + 1) % OEM7_HEALTH_SAMPLES);
+	if (_size < OEM7_HEALTH_SAMPLES) ++_size;
+	if (_count == 0 || reading.value < _min) _min = reading.value;
+	if (_count == 0 || reading.value > _max) _max = reading.value;
+	_sum += reading.value;
+	// First reading reports its status, then transitions only
+	const bool changed = _count++ == 0 || reading.boundary != _change.to;
+	if (!changed) return false;
+	_change.from = _change.to;
+	_change.to = reading.boundary;
+	_change.week = head.week;
+	_change.ms = head.ms;
+	_change.received = received;
+	++_changes;
+	return true;
+}
+
+size_t oem7::HardwareHealth::update(const Head& head, const HWMonitor* readings, const uint32_t count, const uint32_t received, HealthHandler fn, void* context)
+{
+	size_t reported = 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		const HWMonitor& reading = readings[i];
+		if (reading.type == HW_RESERVED) continue;
+		size_t s = 0;
+		while (s < _count && _sensors[s]._type != reading.type) ++s;
+		if (s == _count) {
+			if (_count >= OEM7_HEALTH_SENSORS) {
+				++_overflow;
+				continue;
+			}
+			_sensors[s] = HealthSensor();
+			_sensors[s]._type = reading.type;
+			++_count;
+		}
+		if (!_sensors[s].add(head, reading, received)) continue;
+		++reported;
+		if (fn != nullptr) fn(_sensors[s], context);
+	}
+	return reported;
+}
+
+const oem7::HealthSensor* oem7::HardwareHealth::find(const uint8_t type) const
+{
+	for (size_t i = 0; i < _count; ++i) {
+		if (_sensors[i]._type == type) return &_sensors[i];
+	}
+	return nullptr;
+}
+
+oem7::Severity oem7::HardwareHealth::severity() const
+{
+	Severity result = SEVERITY_INFO;
+	for (size_t i = 0; i < _count; ++i) {
+		const Severity s = _sensors[i].severity();
+		if (s > result) result = s;
+	}
+	return result;
+}
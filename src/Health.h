@@ -0,0 +1,147 @@
+/// \file       Health.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_HEALTH_H__
+#define __OEM7_HEALTH_H__
+
+#include "oem7.h"
+#include "Diagnostics.h"
+#include <stddef.h>
+
+/// \def OEM7_HEALTH_SENSORS
+/// \brief Number of \c HWMONITOR reading types tracked by oem7::HardwareHealth
+/// \details Declare in build flags to override
+#ifndef OEM7_HEALTH_SENSORS
+# define OEM7_HEALTH_SENSORS 12
+#endif
+/// \def OEM7_HEALTH_SAMPLES
+/// \brief Recent readings kept per type (one per \c HWMONITOR log)
+#ifndef OEM7_HEALTH_SAMPLES
+# define OEM7_HEALTH_SAMPLES 16
+#endif
+
+namespace oem7 {
+    /// \struct oem7::BoundaryChange Health.h
+    /// \brief Boundary limit status transition of a hardware reading
+    /// \ingroup oem7rec
+    struct BoundaryChange {
+        uint8_t from{ BOUNDARY_ACCEPT };    ///< Previous status (See: \b Boundary \b Limit \b Status enumerator)
+        uint8_t to{ BOUNDARY_ACCEPT };      ///< New status
+        uint16_t week{ 0 };                 ///< GPS reference week of the log
+        uint32_t ms{ 0 };                   ///< Milliseconds of the GPS reference week of the log
+        uint32_t received{ 0 };             ///< Host monotonic receive time of the log (us)
+    };
+
+    /// \class oem7::HealthSensor Health.h
+    /// \brief Readings of one \c HWMONITOR type: latest, recent, extremes and mean since the first one
+    /// \ingroup oem7rec
+    class HealthSensor {
+        friend class HardwareHealth;
+    public:
+        /// \return Reading type (See: \b Reading \b Type enumerator)
+        inline uint8_t type() const { return _type; }
+        /// \return Latest reading
+        inline float value() const { return sample(0); }
+        /// \return Latest boundary limit status (See: \b Boundary \b Limit \b Status enumerator)
+        inline uint8_t boundary() const { return _change.to; }
+        /// \return Severity of the latest boundary limit status
+        Severity severity() const;
+        /// \return The lowest reading
+        inline float min() const { return _min; }
+        /// \return The highest reading
+        inline float max() const { return _max; }
+        /// \return Mean of all readings
+        inline float mean() const { return _count > 0 ? static_cast<float>(_sum / _count) : 0.0f; }
+        /// \return Number of all readings
+        inline uint32_t count() const { return _count; }
+        /// \return Number of recent readings kept, up to \c OEM7_HEALTH_SAMPLES
+        inline size_t size() const { return _size; }
+        /// \param idx Age of reading: 0 - latest, up to \c size() - 1
+        /// \return Recent reading
+        inline float sample(const size_t idx) const
+        {
+            return idx < _size ? _samples[(_next + OEM7_HEALTH_SAMPLES - 1 - idx) % OEM7_HEALTH_SAMPLES] : 0.0f;
+        }
+        /// \return The latest boundary limit status transition (the first reading counts as one)
+        inline const BoundaryChange& change() const { return _change; }
+        /// \return Number of boundary limit status transitions
+        inline uint32_t changes() const { return _changes; }
+    private:
+        /// \brief Add reading
+        /// \return Boundary limit status changed
+        bool add(const Head& head, const HWMonitor& reading, const uint32_t received);
+    private:
+        float _samples[OEM7_HEALTH_SAMPLES]{};
+        float _min{ 0 };
+        float _max{ 0 };
+        double _sum{ 0 };
+        uint32_t _count{ 0 };
+        uint32_t _changes{ 0 };
+        BoundaryChange _change;
+        uint8_t _next{ 0 };
+        uint8_t _size{ 0 };
+        uint8_t _type{ HW_RESERVED };
+    };
+
+    /// \brief Boundary limit status transition handler
+    /// \param sensor Readings with the new transition in \c HealthSensor::change()
+    /// \param context User context passed at registration
+    typedef void (*HealthHandler)(const HealthSensor& sensor, void* context);
+
+    /// \class oem7::HardwareHealth Health.h
+    /// \brief Fixed-capacity table of \c HWMONITOR readings by type, no heap allocation
+    /// \details Sensors are kept in order of the first reading. Example: \code
+    /// for (const oem7::HealthSensor& sensor : gnss.hardware()) {
+    ///     printf("%u: %.2f (%.2f..%.2f)\n", sensor.type(), sensor.value(), sensor.min(), sensor.max());
+    /// }
+    /// \endcode
+    /// \details See: https://docs.novatel.com/OEM7/Content/Logs/HWMONITOR.htm
+    /// \ingroup oem7rec
+    class HardwareHealth {
+        HardwareHealth(const HardwareHealth&) = delete;
+        HardwareHealth& operator = (const HardwareHealth&) = delete;
+    public:
+        /// \brief Constructor
+        HardwareHealth() {}
+    public:
+        /// \brief Add readings of one \c HWMONITOR log
+        /// \details \c HW_RESERVED readings are skipped, types beyond \c OEM7_HEALTH_SENSORS are counted by \c overflow()
+        /// \param head Message header
+        /// \param readings Readings
+        /// \param count Number of readings
+        /// \param received Host monotonic receive time (us)
+        /// \param fn Boundary limit status transition handler (may be \c nullptr)
+        /// \param context User context
+        /// \return Number of transitions
+        size_t update(const Head& head, const HWMonitor* readings, const uint32_t count, const uint32_t received, HealthHandler fn, void* context);
+        /// \param type Reading type (See: \b Reading \b Type enumerator)
+        /// \return Sensor or \c nullptr if no reading of this type was received
+        const HealthSensor* find(const uint8_t type) const;
+        /// \return The highest severity of the latest boundary limit statuses
+        Severity severity() const;
+        /// \brief Forget all readings
+        inline void clear() { _count = 0; }
+    public:
+        /// \return Number of sensors
+        inline size_t size() const { return _count; }
+        /// \return Capacity
+        static constexpr size_t capacity() { return OEM7_HEALTH_SENSORS; }
+        /// \return Number of readings of types that did not fit into the table
+        inline uint32_t overflow() const { return _overflow; }
+        /// \param idx Sensor index (less than \c size())
+        /// \return Sensor
+        inline const HealthSensor& operator [] (const size_t idx) const { return _sensors[idx]; }
+        /// \return First sensor
+        inline const HealthSensor* begin() const { return &_sensors[0]; }
+        /// \return Sensor after the last one
+        inline const HealthSensor* end() const { return &_sensors[_count]; }
+    private:
+        HealthSensor _sensors[OEM7_HEALTH_SENSORS];
+        size_t _count{ 0 };
+        uint32_t _overflow{ 0 };
+    };
+}
+
+#endif // __OEM7_HEALTH_H__
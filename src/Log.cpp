@@ -0,0 +1,209 @@
+/// \file       Log.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Log.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ESP8266) || defined(ESP32)
+# include "HardwareSerial.h"
+#endif
+#if OEM7_LOG_THREADS
+# include <mutex>
+#endif
+
+static_assert(OEM7_LOG_STRINGS > 0 && OEM7_LOG_STRINGS < 256, "OEM7_LOG_STRINGS must be 1..255");
+static_assert(OEM7_LOG_ARGS < 256, "OEM7_LOG_ARGS must be less than 256");
+
+namespace {
+	void defaultSink(const uint8_t level, const char* text, void* context)
+	{
+		(void)level;
+		(void)context;
+#if defined(ESP8266) || defined(ESP32)
+		Serial.print(text);
+#else
+		fputs(text, stdout);
+#endif
+	}
+
+	oem7::LogSink sink = &defaultSink;
+	void* sinkContext = nullptr;
+	uint32_t lost = 0;
+
+	bool digit(const char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+}
+
+#if OEM7_LOG_LEVEL > OEM7_LOG_NONE && OEM7_LOG_DEFERRED
+namespace {
+	size_t head = 0;
+	size_t count = 0;
+#if OEM7_LOG_THREADS
+	std::mutex guard;
+#endif
+}
+#endif
+
+oem7::Log::Record* oem7::Log::ring()
+{
+#if OEM7_LOG_LEVEL > OEM7_LOG_NONE && OEM7_LOG_DEFERRED
+	static Record records[OEM7_LOG_RECORDS];
+	return &records[0];
+#else
+	return nullptr;
+#endif
+}
+
+void oem7::Log::setSink(LogSink fn, void* context)
+{
+	sink = fn != nullptr ? fn : &defaultSink;
+	sinkContext = fn != nullptr ? context : nullptr;
+}
+
+uint32_t oem7::Log::dropped()
+{
+	return lost;
+}
+
+size_t oem7::Log::store(Record& record, const char* text)
+{
+	// Last byte is always the terminator: empty string once storage is full
+	const size_t last = OEM7_LOG_STRINGS - 1;
+	record.strings[last] = '\0';
+	if (text == nullptr) text = "(null)";
+	const size_t offset = record.used;
+	if (offset >= last) return last;
+	size_t n = strlen(text);
+	if (n > last - offset) n = last - offset;
+	memcpy(&record.strings[offset], text, n);
+	record.strings[offset + n] = '\0';
+	record.used = static_cast<uint8_t>(offset + n + 1 > last ? last : offset + n + 1);
+	return offset;
+}
+
+void oem7::Log::commit(const Record& record)
+{
+#if OEM7_LOG_LEVEL > OEM7_LOG_NONE && OEM7_LOG_DEFERRED
+# if OEM7_LOG_THREADS
+	std::lock_guard<std::mutex> lock(guard);
+# endif
+	if (count >= OEM7_LOG_RECORDS) {
+		++lost;
+		return;
+	}
+	ring()[(head + count) % OEM7_LOG_RECORDS] = record;
+	++count;
+#else
+	output(record);
+#endif
+}
+
+size_t oem7::Log::flush()
+{
+	size_t n = 0;
+#if OEM7_LOG_LEVEL > OEM7_LOG_NONE && OEM7_LOG_DEFERRED
+	Record record;
+	for (;;) {
+		{
+# if OEM7_LOG_THREADS
+			std::lock_guard<std::mutex> lock(guard);
+# endif
+			if (count == 0) break;
+			record = ring()[head];
+			head = (head + 1) % OEM7_LOG_RECORDS;
+			--count;
+		}
+		// Formatting and output out of the lock
+		output(record);
+		++n;
+	}
+#endif
+	return n;
+}
+
+void oem7::Log::output(const Record& record)
+{
+	char line[OEM7_LOG_LINE];
+	const size_t size = sizeof(line) - 1;
+	size_t n = 0;
+	const auto advance = [&](const int written) {
+		if (written > 0) n += static_cast<size_t>(written) < size - n ? static_cast<size_t>(written) : size - n;
+	};
+	if (record.level == OEM7_LOG_DEBUG && record.func != nullptr) {
+		advance(snprintf(&line[0], sizeof(line), "[%s:%i] ", record.func, record.line));
+	}
+	const char* p = record.fmt != nullptr ? record.fmt : "";
+	uint8_t a = 0;
+	while (*p != '\0' && n < size) {
+		if (*p != '%') {
+			line[n++] = *p++;
+			continue;
+		}
+		if (p[1] == '%') {
+			line[n++] = '%';
+			p += 2;
+			continue;
+		}
+		// Conversion: flags, width and precision are kept, length is replaced by long (no long long printf on some MCUs)
+		char spec[24];
+		size_t k = 0;
+		spec[k++] = *p++;
+		while (*p != '\0' && strchr("-+ #0", *p) != nullptr && k < 6) spec[k++] = *p++;
+		while (digit(*p) && k < 10) spec[k++] = *p++;
+		if (*p == '.') {
+			spec[k++] = *p++;
+			while (digit(*p) && k < 14) spec[k++] = *p++;
+		}
+		while (*p != '\0' && strchr("hljztL", *p) != nullptr) ++p;
+		const char conv = *p;
+		if (conv == '\0' || a >= record.count) break;
+		++p;
+		const Arg& arg = record.args[a++];
+		char* out = &line[n];
+		const size_t room = sizeof(line) - n;
+		switch (conv) {
+		case 'd':
+		case 'i':
+			spec[k++] = 'l'; spec[k++] = conv; spec[k] = '\0';
+			advance(snprintf(out, room, spec, static_cast<long>(arg.i)));
+			break;
+		case 'u':
+		case 'x':
+		case 'X':
+		case 'o':
+			spec[k++] = 'l'; spec[k++] = conv; spec[k] = '\0';
+			advance(snprintf(out, room, spec, static_cast<unsigned long>(arg.u)));
+			break;
+		case 'c':
+			spec[k++] = conv; spec[k] = '\0';
+			advance(snprintf(out, room, spec, static_cast<int>(arg.u & 0xFF)));
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+			spec[k++] = conv; spec[k] = '\0';
+			advance(snprintf(out, room, spec, arg.f));
+			break;
+		case 's':
+			spec[k++] = conv; spec[k] = '\0';
+			advance(snprintf(out, room, spec, &record.strings[arg.s < OEM7_LOG_STRINGS ? arg.s : OEM7_LOG_STRINGS - 1]));
+			break;
+		case 'p':
+			spec[k++] = conv; spec[k] = '\0';
+			advance(snprintf(out, room, spec, arg.p));
+			break;
+		default:
+			break;
+		}
+	}
+	line[n] = '\0';
+	sink(record.level, &line[0], sinkContext);
+}
@@ -0,0 +1,195 @@
+/// \file       Log.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_LOG_H__
+#define __OEM7_LOG_H__
+
+#include "Config.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+/// \def OEM7_LOG_NONE
+/// \brief Log level: no log
+#define OEM7_LOG_NONE       0
+/// \def OEM7_LOG_ERROR
+/// \brief Log level: errors
+#define OEM7_LOG_ERROR      1
+/// \def OEM7_LOG_WARNING
+/// \brief Log level: errors and warnings
+#define OEM7_LOG_WARNING    2
+/// \def OEM7_LOG_INFO
+/// \brief Log level: errors, warnings, commands, status and hardware monitor
+#define OEM7_LOG_INFO       3
+/// \def OEM7_LOG_DEBUG
+/// \brief Log level: everything, including decoded solutions and parse errors
+#define OEM7_LOG_DEBUG      4
+
+/// \def OEM7_LOG_LEVEL
+/// \brief Compile-time log level: sites above it are removed by the preprocessor
+/// \details \c OEM7_LOG_DEBUG if \b DEBUGLOG is declared, otherwise \c OEM7_LOG_INFO. Declare in build flags to override
+#ifndef OEM7_LOG_LEVEL
+# ifdef DEBUGLOG
+#  define OEM7_LOG_LEVEL OEM7_LOG_DEBUG
+# else
+#  define OEM7_LOG_LEVEL OEM7_LOG_INFO
+# endif
+#endif
+/// \def OEM7_LOG_DEFERRED
+/// \brief Deferred log: arguments are captured into a ring, formatted and output by \c Log::flush()
+/// \details 0 - format and output at once. Declare in build flags to override
+#ifndef OEM7_LOG_DEFERRED
+# define OEM7_LOG_DEFERRED 1
+#endif
+/// \def OEM7_LOG_RECORDS
+/// \brief Capacity of the deferred log ring (records)
+#ifndef OEM7_LOG_RECORDS
+# define OEM7_LOG_RECORDS 16
+#endif
+/// \def OEM7_LOG_ARGS
+/// \brief Maximum number of arguments of one log record
+#ifndef OEM7_LOG_ARGS
+# define OEM7_LOG_ARGS 12
+#endif
+/// \def OEM7_LOG_STRINGS
+/// \brief String argument storage of one log record (in bytes), longer strings are truncated
+#ifndef OEM7_LOG_STRINGS
+# define OEM7_LOG_STRINGS 64
+#endif
+/// \def OEM7_LOG_LINE
+/// \brief Formatted line size (in bytes), longer lines are truncated
+#ifndef OEM7_LOG_LINE
+# define OEM7_LOG_LINE 192
+#endif
+/// \def OEM7_LOG_THREADS
+/// \brief Log records may come from several threads: ring is guarded by a mutex
+#ifndef OEM7_LOG_THREADS
+# if defined(ESP32) || !(defined(ESP8266) || defined(ARDUINO))
+#  define OEM7_LOG_THREADS 1
+# else
+#  define OEM7_LOG_THREADS 0
+# endif
+#endif
+
+namespace oem7 {
+    /// \brief Log output
+    /// \param level Log level (\c OEM7_LOG_ERROR ... \c OEM7_LOG_DEBUG)
+    /// \param text Formatted line, valid during the call only
+    /// \param context User context passed at installation
+    typedef void (*LogSink)(const uint8_t level, const char* text, void* context);
+
+    /// \class oem7::Log Log.h
+    /// \brief Library log
+    /// \details Log sites are the \c OEM7_LOG_E(), \c OEM7_LOG_W(), \c OEM7_LOG_I() and \c OEM7_LOG_D() macros:
+    /// \details sites above \c OEM7_LOG_LEVEL are removed at compile time, arguments are not evaluated.
+    /// \details With \c OEM7_LOG_DEFERRED an enabled site only copies its format pointer and arguments (strings by value)
+    /// \details into a fixed ring, so no formatting and no serial output happen on the parsing path.
+    /// \details \c Log::flush() formats the records and passes them to the sink, it is called by \c Receiver::update(),
+    /// \details \c Receiver::waitCommands() and the first worker of oem7::ReceiverPool, or by the application.
+    /// \details Format must be a string literal, conversions \c d \c i \c u \c x \c X \c o \c c \c f \c e \c g \c s \c p
+    /// \details without \c * width are supported, integers are printed as \c long.
+    /// \ingroup oem7rec
+    class Log {
+        Log() = delete;
+    public:
+        /// \brief Install log output
+        /// \details Default output is \c Serial on Arduino and \c stdout on Win32 and POSIX. Install before logging starts
+        /// \param fn Sink or \c nullptr to restore default output
+        /// \param context User context passed to sink
+        static void setSink(LogSink fn, void* context = nullptr);
+        /// \brief Format and output deferred records
+        /// \return Number of records output
+        static size_t flush();
+        /// \return Number of records dropped because the ring was full
+        static uint32_t dropped();
+        /// \brief Log record, use the \c OEM7_LOG_* macros instead
+        /// \param level Log level
+        /// \param func Function name (literal) or \c nullptr
+        /// \param line Source line
+        /// \param fmt \c printf format (literal)
+        /// \param args Arguments: integers, enumerations, floating point, strings and pointers
+        template <typename... Args>
+        static void write(const uint8_t level, const char* func, const int line, const char* fmt, const Args&... args)
+        {
+            static_assert(sizeof...(Args) <= OEM7_LOG_ARGS, "Too many log arguments, see OEM7_LOG_ARGS");
+            Record record;
+            record.level = level;
+            record.line = line;
+            record.func = func;
+            record.fmt = fmt;
+            int unused[] = { 0, (capture(record, args), 0)... };
+            (void)unused;
+            commit(record);
+        }
+    private:
+        /// \brief Captured argument
+        union Arg {
+            long long i;
+            unsigned long long u;
+            double f;
+            const void* p;
+            size_t s;               ///< Offset of string in oem7::Log::Record::strings
+        };
+        /// \brief Captured log site
+        struct Record {
+            uint8_t level{ 0 };
+            uint8_t count{ 0 };
+            uint8_t used{ 0 };
+            int line{ 0 };
+            const char* func{ nullptr };
+            const char* fmt{ nullptr };
+            Arg args[OEM7_LOG_ARGS > 0 ? OEM7_LOG_ARGS : 1];
+            char strings[OEM7_LOG_STRINGS];
+        };
+    private:
+        template <typename T>
+        static void capture(Record& record, const T& value)
+        {
+            Arg& arg = record.args[record.count++];
+            if constexpr (std::is_floating_point<T>::value) arg.f = static_cast<double>(value);
+            else if constexpr (std::is_enum<T>::value) arg.i = static_cast<long long>(value);
+            else if constexpr (std::is_signed<T>::value) arg.i = static_cast<long long>(value);
+            else if constexpr (std::is_integral<T>::value) arg.u = static_cast<unsigned long long>(value);
+            else if constexpr (std::is_convertible<T, const char*>::value) arg.s = store(record, value);
+            else arg.p = static_cast<const void*>(value);
+        }
+        /// \return Deferred record ring or \c nullptr
+        static Record* ring();
+        /// \brief Copy string argument
+        static size_t store(Record& record, const char* text);
+        /// \brief Queue record or output it at once
+        static void commit(const Record& record);
+        /// \brief Format record and pass it to the sink
+        static void output(const Record& record);
+    };
+}
+
+#define OEM7_LOG_SITE(level, fmt, ...) oem7::Log::write(level, __FUNCTION__, __LINE__, fmt, ##__VA_ARGS__)
+#if OEM7_LOG_LEVEL >= OEM7_LOG_ERROR
+/// \brief Log error
+# define OEM7_LOG_E(fmt, ...) OEM7_LOG_SITE(OEM7_LOG_ERROR, fmt, ##__VA_ARGS__)
+#else
+# define OEM7_LOG_E(fmt, ...) do {} while (0)
+#endif
+#if OEM7_LOG_LEVEL >= OEM7_LOG_WARNING
+/// \brief Log warning
+# define OEM7_LOG_W(fmt, ...) OEM7_LOG_SITE(OEM7_LOG_WARNING, fmt, ##__VA_ARGS__)
+#else
+# define OEM7_LOG_W(fmt, ...) do {} while (0)
+#endif
+#if OEM7_LOG_LEVEL >= OEM7_LOG_INFO
+/// \brief Log information
+# define OEM7_LOG_I(fmt, ...) OEM7_LOG_SITE(OEM7_LOG_INFO, fmt, ##__VA_ARGS__)
+#else
+# define OEM7_LOG_I(fmt, ...) do {} while (0)
+#endif
+#if OEM7_LOG_LEVEL >= OEM7_LOG_DEBUG
+/// \brief Log debug information, prefixed by function and line
+# define OEM7_LOG_D(fmt, ...) OEM7_LOG_SITE(OEM7_LOG_DEBUG, fmt, ##__VA_ARGS__)
+#else
+# define OEM7_LOG_D(fmt, ...) do {} while (0)
+#endif
+
+#endif // __OEM7_LOG_H__
@@ -0,0 +1,136 @@
+/// \file       LogProfile.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_LOGPROFILE_H__
+#define __OEM7_LOGPROFILE_H__
+
+#include "oem7.h"
+#include <stddef.h>
+
+namespace oem7 {
+    /// \struct oem7::LogRequest LogProfile.h
+    /// \brief One log subscription
+    /// \ingroup oem7rec
+    struct LogRequest {
+        uint16_t msgId;     ///< Message ID (binary format is requested). Short header logs have own IDs, e.g. \c MSG_INSATTS
+        uint8_t trigger;    ///< Trigger (See: \b Log \b Trigger enumerator)
+        double period;      ///< Period for \c ONTIME trigger (s)
+    };
+    /// \struct oem7::StatusEvents LogProfile.h
+    /// \brief Status bits reported by \c RXSTATUSEVENT
+    /// \details Bits of each status word, set to \c STATUSCONFIG \c SET and \c CLEAR masks: the receiver logs
+    /// \details an event when any of them changes. Receiver error word always reports events
+    /// \ingroup oem7rec
+    struct StatusEvents {
+        uint32_t mask[WORD_AUX4 + 1];   ///< Mask by status word (See: \b Status \b Word enumerator)
+    };
+    /// \struct oem7::LogProfile LogProfile.h
+    /// \brief Set of log subscriptions used by \c Receiver::begin()
+    /// \details Literal type: may be built and checked at compile time. Example: \code
+    /// static constexpr oem7::LogRequest boat[] = {
+    ///     { oem7::MSG_DUALANTHEADING, oem7::TRIGGER_ONTIME, 0.05 },
+    ///     { oem7::MSG_RXSTATUS, oem7::TRIGGER_ONCHANGED, 0.0 }
+    /// };
+    /// static constexpr oem7::LogProfile profile(boat);
+    /// static_assert(profile.valid(), "Wrong log profile");
+    /// \endcode
+    /// \details With \c RXSTATUSEVENT and status events the receiver status is updated by events, so \c RXSTATUS
+    /// \details may be a slow heartbeat (see oem7::EVENT_PROFILE)
+    /// \details Requests are not copied: keep the array static
+    /// \ingroup oem7rec
+    struct LogProfile {
+        const LogRequest* logs{ nullptr };      ///< Requests
+        size_t count{ 0 };                      ///< Number of requests
+        uint32_t port{ PORT_COM1 };             ///< Output port (See: \b Detailed \b Port \b Identifier enumerator)
+        const StatusEvents* events{ nullptr };  ///< Status events set by \c STATUSCONFIG or \c nullptr - masks are not changed
+        /// \brief Empty profile: no logs
+        constexpr LogProfile() {}
+        /// \brief Profile of request array
+        /// \param requests Requests
+        /// \param outPort Output port (See: \b Detailed \b Port \b Identifier enumerator)
+        /// \param statusEvents Status events, used with \c RXSTATUSEVENT request
+        template <size_t N>
+        constexpr LogProfile(const LogRequest (&requests)[N], const uint32_t outPort = PORT_COM1, const StatusEvents* statusEvents = nullptr) :
+            logs(&requests[0]), count(N), port(outPort), events(statusEvents) {}
+        /// \param msgId Message ID
+        /// \return Message is requested
+        constexpr bool has(const uint16_t msgId) const
+        {
+            for (size_t i = 0; i < count; ++i) {
+                if (logs[i].msgId == msgId) return true;
+            }
+            return false;
+        }
+        /// \return Every \c ONTIME request has positive period and no message is requested twice
+        constexpr bool valid() const
+        {
+            for (size_t i = 0; i < count; ++i) {
+                if (logs[i].trigger == TRIGGER_ONTIME && !(logs[i].period > 0.0)) return false;
+                for (size_t j = i + 1; j < count; ++j) {
+                    if (logs[i].msgId == logs[j].msgId) return false;
+                }
+            }
+            return true;
+        }
+    };
+    /// \brief Requests of the default profile
+    /// \details \c HWMONITOR, \c RXSTATUS and \c TIME at 1 Hz, \c BESTPOS and \c DUALANTENNAHEADING at 4 Hz
+    /// \ingroup oem7rec
+    inline constexpr LogRequest DEFAULT_LOGS[] = {
+        { MSG_HWMONITOR, TRIGGER_ONTIME, 1.0 },
+        { MSG_RXSTATUS, TRIGGER_ONTIME, 1.0 },
+        { MSG_TIME, TRIGGER_ONTIME, 1.0 },
+        { MSG_BESTPOS, TRIGGER_ONTIME, 0.25 },
+        { MSG_DUALANTHEADING, TRIGGER_ONTIME, 0.25 }
+    };
+    /// \brief Default profile
+    /// \ingroup oem7rec
+    inline constexpr LogProfile DEFAULT_PROFILE{ DEFAULT_LOGS };
+    static_assert(DEFAULT_PROFILE.valid(), "Wrong default log profile");
+    /// \brief Status events of the health check
+    /// \details Antenna power, LNA, open and short circuit, gain, jamming, spoofing, position and clock validity
+    /// \ingroup oem7rec
+    inline constexpr StatusEvents HEALTH_EVENTS{ {
+        0,              // Receiver error: always reported
+        0x004CC278,     // Status: antenna 1, spoofing, gain, jammer, almanac/UTC, position, clock model
+        0,              // Aux 1
+        0x70000000,     // Aux 2: antenna 2 power, open and short circuit
+        0x000000F0,     // Aux 3: antenna 1 and 2 gain state
+        0               // Aux 4
+    } };
+    /// \brief Requests of the event profile
+    /// \details As oem7::DEFAULT_LOGS, but \c RXSTATUSEVENT on new events and \c RXSTATUS heartbeat every 30 s
+    /// \ingroup oem7rec
+    inline constexpr LogRequest EVENT_LOGS[] = {
+        { MSG_HWMONITOR, TRIGGER_ONTIME, 1.0 },
+        { MSG_RXSTATUSEVENT, TRIGGER_ONNEW, 0.0 },
+        { MSG_RXSTATUS, TRIGGER_ONTIME, 30.0 },
+        { MSG_TIME, TRIGGER_ONTIME, 1.0 },
+        { MSG_BESTPOS, TRIGGER_ONTIME, 0.25 },
+        { MSG_DUALANTHEADING, TRIGGER_ONTIME, 0.25 }
+    };
+    /// \brief Event profile: receiver status by \c RXSTATUSEVENT of oem7::HEALTH_EVENTS
+    /// \ingroup oem7rec
+    inline constexpr LogProfile EVENT_PROFILE{ EVENT_LOGS, PORT_COM1, &HEALTH_EVENTS };
+    static_assert(EVENT_PROFILE.valid(), "Wrong event log profile");
+    /// \brief Requests of the SPAN profile
+    /// \details As oem7::DEFAULT_LOGS plus short header \c INSATTS at 50 Hz: 56 bytes per epoch instead of 72
+    /// \details of the long header \c INSATT, 28 kbit/s of a 115200 link. Needs a SPAN (INS) receiver
+    /// \ingroup oem7rec
+    inline constexpr LogRequest SPAN_LOGS[] = {
+        { MSG_HWMONITOR, TRIGGER_ONTIME, 1.0 },
+        { MSG_RXSTATUS, TRIGGER_ONTIME, 1.0 },
+        { MSG_TIME, TRIGGER_ONTIME, 1.0 },
+        { MSG_BESTPOS, TRIGGER_ONTIME, 0.25 },
+        { MSG_DUALANTHEADING, TRIGGER_ONTIME, 0.25 },
+        { MSG_INSATTS, TRIGGER_ONTIME, 0.02 }
+    };
+    /// \brief SPAN profile: attitude by short header \c INSATTS
+    /// \ingroup oem7rec
+    inline constexpr LogProfile SPAN_PROFILE{ SPAN_LOGS };
+    static_assert(SPAN_PROFILE.valid(), "Wrong SPAN log profile");
+}
+
+#endif // __OEM7_LOGPROFILE_H__
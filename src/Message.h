@@ -0,0 +1,135 @@
+/// \file       Message.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_MESSAGE_H__
+#define __OEM7_MESSAGE_H__
+
+#include "oem7.h"
+#include <stddef.h>
+#include <string.h>
+
+/// \def OEM7_RECORD_SIZE
+/// \brief Body capacity of oem7::Record (in bytes)
+/// \details Fits every log of this library except \c VERSION. Declare in build flags to override
+#ifndef OEM7_RECORD_SIZE
+# define OEM7_RECORD_SIZE 96
+#endif
+
+namespace oem7 {
+    /// \struct oem7::Frame Message.h
+    /// \brief Validated binary frame
+    /// \details Points into the receiver frame buffer: valid until the next read
+    /// \details Header of a short header frame is expanded into oem7::Head: message ID, length, week and
+    /// \details milliseconds are set, time status is \c GPSTIME_UNKNOWN and the other fields are 0
+    /// \ingroup oem7rec
+    struct Frame {
+        const Head* head{ nullptr };    ///< Message header
+        const uint8_t* body{ nullptr }; ///< Message body
+        size_t size{ 0 };               ///< Body size (in bytes)
+        uint32_t received{ 0 };         ///< Host monotonic time of the serial read completing the frame (us)
+        uint8_t header{ HEAD_LENGHT };  ///< Header length on the wire: \c HEAD_LENGHT or \c HEAD_SHORT_LENGHT
+        /// \return Message ID or 0 if frame is empty
+        inline uint16_t id() const { return head ? head->msgId : 0; }
+        /// \return Frame has short header
+        inline bool isShort() const { return header == HEAD_SHORT_LENGHT; }
+    };
+    /// \struct oem7::Record Message.h
+    /// \brief Copy of a validated frame
+    /// \details Used to pass messages between threads. Read it with oem7::MessageView through \c frame()
+    /// \ingroup oem7rec
+    struct Record {
+        Head head{};                        ///< Message header
+        uint8_t body[OEM7_RECORD_SIZE]{};   ///< Message body
+        uint32_t received{ 0 };             ///< Host monotonic receive time (us), see oem7::Frame::received
+        uint8_t header{ HEAD_LENGHT };      ///< Header length on the wire, see oem7::Frame::header
+        /// \brief Copy frame
+        /// \param frame Validated frame
+        /// \return \c false if body does not fit
+        inline bool assign(const Frame& frame)
+        {
+            if (frame.head == nullptr || frame.size > sizeof(body)) return false;
+            head = *frame.head;
+            memcpy(&body[0], frame.body, frame.size);
+            received = frame.received;
+            header = frame.header;
+            return true;
+        }
+        /// \return Frame over the record
+        inline Frame frame() const { Frame f; f.head = &head; f.body = &body[0]; f.size = head.msgLenght; f.received = received; f.header = header; return f; }
+    };
+    /// \class oem7::MessageView Message.h
+    /// \brief Typed zero-copy view of a fixed size message
+    /// \details Empty if frame has other message ID or size
+    /// \details Structures are packed (\ref strualign "1-byte alignment"), so body may be addressed in place
+    /// \tparam T Message structure: oem7::BestPos, oem7::DualAntHeading, oem7::Time etc
+    /// \ingroup oem7rec
+    template <typename T>
+    class MessageView {
+    public:
+        /// \brief Empty view
+        MessageView() {}
+        /// \brief View of frame
+        /// \param frame Validated frame
+        /// \param msgId Expected message ID
+        MessageView(const Frame& frame, const uint16_t msgId)
+        {
+            if (frame.id() != msgId || frame.size != sizeof(T)) return;
+            _head = frame.head;
+            _body = reinterpret_cast<const T*>(frame.body);
+        }
+    public:
+        /// \return View is not empty
+        inline explicit operator bool() const { return _body != nullptr; }
+        /// \return Message header
+        inline const Head& head() const { return *_head; }
+        /// \return Message body
+        inline const T& operator * () const { return *_body; }
+        /// \return Message body
+        inline const T* operator -> () const { return _body; }
+    private:
+        const Head* _head{ nullptr };
+        const T* _body{ nullptr };
+    };
+    /// \class oem7::ListView Message.h
+    /// \brief Typed zero-copy view of a count-prefixed message
+    /// \details Used by oem7::Version and oem7::HWMonitor logs: \c uint32_t number of records followed by records
+    /// \tparam T Record structure
+    /// \ingroup oem7rec
+    template <typename T>
+    class ListView {
+    public:
+        /// \brief Empty view
+        ListView() {}
+        /// \brief View of frame
+        /// \param frame Validated frame
+        /// \param msgId Expected message ID
+        ListView(const Frame& frame, const uint16_t msgId)
+        {
+            if (frame.id() != msgId || frame.size < sizeof(uint32_t)) return;
+            uint32_t count = 0;
+            memcpy(&count, frame.body, sizeof(uint32_t));
+            if (frame.size - sizeof(uint32_t) != count * sizeof(T)) return;
+            _head = frame.head;
+            _body = reinterpret_cast<const T*>(frame.body + sizeof(uint32_t));
+            _count = count;
+        }
+    public:
+        /// \return View is not empty
+        inline explicit operator bool() const { return _body != nullptr; }
+        /// \return Message header
+        inline const Head& head() const { return *_head; }
+        /// \return Number of records
+        inline uint32_t count() const { return _count; }
+        /// \param idx Record index (less than \c count())
+        /// \return Record
+        inline const T& operator [] (const uint32_t idx) const { return _body[idx]; }
+    private:
+        const Head* _head{ nullptr };
+        const T* _body{ nullptr };
+        uint32_t _count{ 0 };
+    };
+}
+
+#endif // __OEM7_MESSAGE_H__
@@ -0,0 +1,175 @@
+/// \file       Pool.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#if defined(_WIN32) && !defined(ESP8266) && !defined(ESP32)
+// Before windows.h of serialib: it would include winsock.h
+# include <winsock2.h>
+#endif
+#include "Pool.h"
+#include "Log.h"
+
+#if !defined(ESP8266) && !defined(ESP32)
+#include <chrono>
+#include <vector>
+#if defined(__linux__)
+# include <pthread.h>
+# include <sys/epoll.h>
+# include <unistd.h>
+#elif !defined(_WIN32)
+# include <poll.h>
+#endif
+
+template <typename Port>
+oem7::ReceiverPool<Port>::~ReceiverPool()
+{
+	stop();
+}
+
+template <typename Port>
+int oem7::ReceiverPool<Port>::add(BasicReceiver<Port>& receiver)
+{
+	if (isRunning() || _count == OEM7_POOL_LINKS || receiver.transport().handle() < 0) return -1;
+	_links[_count] = &receiver;
+	return static_cast<int>(_count++);
+}
+
+template <typename Port>
+bool oem7::ReceiverPool<Port>::start(unsigned workers, const bool pin)
+{
+	if (_count == 0 || _running.exchange(true)) return false;
+	if (workers == 0) workers = std::thread::hardware_concurrency();
+	if (workers == 0) workers = 1;
+	if (workers > OEM7_POOL_WORKERS) workers = OEM7_POOL_WORKERS;
+	if (workers > _count) workers = static_cast<unsigned>(_count);
+	_active = workers;
+	_next = 0;
+	for (unsigned i = 0; i < _active; ++i) {
+		_workers[i].thread = std::thread(&ReceiverPool::work, this, i);
+		if (!pin) continue;
+#if defined(_WIN32)
+		::SetThreadAffinityMask(_workers[i].thread.native_handle(), static_cast<DWORD_PTR>(1) << i);
+#elif defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(i, &set);
+		pthread_setaffinity_np(_workers[i].thread.native_handle(), sizeof(set), &set);
+#endif
+	}
+	return true;
+}
+
+template <typename Port>
+void oem7::ReceiverPool<Port>::stop()
+{
+	if (!_running.exchange(false)) return;
+	for (unsigned i = 0; i < _active; ++i) {
+		if (_workers[i].thread.joinable()) _workers[i].thread.join();
+	}
+	// Records of the last drain
+	Log::flush();
+}
+
+template <typename Port>
+bool oem7::ReceiverPool<Port>::pop(PoolRecord& record)
+{
+	for (unsigned i = 0; i < _active; ++i) {
+		const unsigned worker = (_next + i) % _active;
+		if (_workers[worker].records.pop(record)) {
+			// Next call starts from the next worker
+			_next = (worker + 1) % _active;
+			return true;
+		}
+	}
+	return false;
+}
+
+template <typename Port>
+void oem7::ReceiverPool<Port>::drain(const unsigned worker, const size_t link)
+{
+	BasicReceiver<Port>& receiver = *_links[link];
+	Ring<PoolRecord, OEM7_POOL_RECORDS>& records = _workers[worker].records;
+	PoolRecord record;
+	record.link = static_cast<uint16_t>(link);
+	Frame frame;
+	// Bytes kept by the transport (rest of a datagram) raise no readiness event: read them too
+	for (unsigned batch = 0; batch < OEM7_POOL_BATCH; ++batch) {
+		while (receiver.read(frame)) {
+			if (!record.record.assign(frame) || !records.push(record)) _dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+		if (!receiver.transport().wait(0)) break;
+	}
+}
+
+template <typename Port>
+void oem7::ReceiverPool<Port>::work(const unsigned worker)
+{
+	// Share of the worker: every _active-th receiver, so each receiver is parsed by one thread only
+#if defined(__linux__)
+	const int ep = ::epoll_create1(EPOLL_CLOEXEC);
+	if (ep < 0) return;
+	for (size_t link = worker; link < _count; link += _active) {
+		epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.u64 = link;
+		::epoll_ctl(ep, EPOLL_CTL_ADD, static_cast<int>(_links[link]->transport().handle()), &event);
+	}
+	epoll_event events[64];
+	while (_running.load(std::memory_order_relaxed)) {
+		// Wake up periodically to check stop request
+		const int n = ::epoll_wait(ep, &events[0], sizeof(events) / sizeof(events[0]), 10);
+		for (int i = 0; i < n; ++i) drain(worker, static_cast<size_t>(events[i].data.u64));
+		// Deferred log of all workers: update() is not called while the pool runs
+		if (worker == 0) Log::flush();
+	}
+	::close(ep);
+#else
+#if defined(_WIN32)
+	typedef WSAPOLLFD PollFd;
+#else
+	typedef pollfd PollFd;
+#endif
+	std::vector<PollFd> fds;
+	std::vector<size_t> links;
+	for (size_t link = worker; link < _count; link += _active) {
+		PollFd fd{};
+		fd.fd = static_cast<decltype(fd.fd)>(_links[link]->transport().handle());
+		fd.events = POLLIN;
+		fds.push_back(fd);
+		links.push_back(link);
+	}
+	while (_running.load(std::memory_order_relaxed)) {
+		if (fds.empty()) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			continue;
+		}
+#if defined(_WIN32)
+		const int n = ::WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), 10);
+#else
+		const int n = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), 10);
+#endif
+		// Deferred log of all workers: update() is not called while the pool runs
+		if (worker == 0) Log::flush();
+		if (n <= 0) continue;
+		for (size_t i = 0; i < fds.size(); ) {
+			if (fds[i].revents != 0) drain(worker, links[i]);
+			fds[i].revents = 0;
+			// Closed transport leaves the poll set
+			if (_links[links[i]]->transport().handle() < 0) {
+				fds.erase(fds.begin() + i);
+				links.erase(links.begin() + i);
+				continue;
+			}
+			++i;
+		}
+	}
+#endif
+}
+
+#if !defined(_WIN32)
+template class oem7::ReceiverPool<oem7::SerialTransport>;
+#endif
+template class oem7::ReceiverPool<oem7::TcpTransport>;
+template class oem7::ReceiverPool<oem7::UdpTransport>;
+#endif
@@ -0,0 +1,124 @@
+/// \file       Pool.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_POOL_H__
+#define __OEM7_POOL_H__
+
+#include "Receiver.h"
+#if !defined(ESP8266) && !defined(ESP32)
+#include "Ring.h"
+#include <atomic>
+#include <thread>
+
+/// \def OEM7_POOL_LINKS
+/// \brief The most receivers of oem7::ReceiverPool
+/// \details Declare in build flags to override
+#ifndef OEM7_POOL_LINKS
+# define OEM7_POOL_LINKS 128
+#endif
+/// \def OEM7_POOL_WORKERS
+/// \brief The most worker threads of oem7::ReceiverPool
+#ifndef OEM7_POOL_WORKERS
+# define OEM7_POOL_WORKERS 8
+#endif
+/// \def OEM7_POOL_RECORDS
+/// \brief Capacity of the output ring of each worker (power of two)
+#ifndef OEM7_POOL_RECORDS
+# define OEM7_POOL_RECORDS 256
+#endif
+/// \def OEM7_POOL_BATCH
+/// \brief The most bulk reads of one receiver per readiness event, so a busy link does not starve the others
+#ifndef OEM7_POOL_BATCH
+# define OEM7_POOL_BATCH 16
+#endif
+
+namespace oem7 {
+    /// \struct oem7::PoolRecord Pool.h
+    /// \brief Message decoded by oem7::ReceiverPool
+    /// \ingroup oem7rec
+    struct PoolRecord {
+        uint16_t link{ 0 };     ///< Receiver index returned by \c ReceiverPool::add()
+        Record record;          ///< Message copy
+    };
+
+    /// \class oem7::ReceiverPool Pool.h
+    /// \brief Many receivers on a fixed set of worker threads, Win32 and POSIX only
+    /// \details Each worker owns a fixed share of the receivers and sleeps in \c epoll_wait() on Linux
+    /// \details (\c poll() / \c WSAPoll() elsewhere) until one of their transports is readable, then drains it with
+    /// \details \c BasicReceiver::read(). So every receiver is parsed by one thread only, and no thread is spent per port.
+    /// \details Decoded messages go to the single consumer through one lock-free ring per worker, see \c pop().
+    /// \details Handlers are called in the workers, the deferred log is output by the first one. While the pool runs do not call \c update(), \c read() or the
+    /// \details commands of its receivers: use \c pop(), \c latest() and \c stats(). Send commands (\c begin(),
+    /// \details \c config()) before \c start() and after \c stop()
+    /// \details Instantiated in Pool.cpp for oem7::TcpTransport, oem7::UdpTransport and, on POSIX,
+    /// \details oem7::SerialTransport with \c watch()
+    /// \tparam Port Transport with \c handle(): socket or descriptor to wait on
+    /// \ingroup oem7rec
+    template <typename Port>
+    class ReceiverPool {
+        ReceiverPool(const ReceiverPool&) = delete;
+        ReceiverPool& operator = (const ReceiverPool&) = delete;
+    public:
+        /// \brief Constructor
+        ReceiverPool() {}
+        /// \brief Destructor: stops workers
+        ~ReceiverPool();
+    public:
+        /// \brief Add receiver
+        /// \details Call before \c start(). Receiver must outlive the pool.
+        /// \details A transport closed meanwhile (peer closed the connection) is left until the next \c start()
+        /// \param receiver Receiver with an open transport
+        /// \return Receiver index or -1 if pool is full, running or transport has no handle
+        int add(BasicReceiver<Port>& receiver);
+        /// \brief Start workers
+        /// \param workers Number of worker threads, 0 - one per core; up to \c OEM7_POOL_WORKERS and receivers
+        /// \param pin Pin worker \c i to core \c i
+        /// \return \c false if already started or no receivers
+        bool start(unsigned workers = 0, const bool pin = false);
+        /// \brief Stop workers and wait for them to exit
+        /// \details Messages left in the rings may still be taken by \c pop()
+        void stop();
+        /// \return Workers are running
+        inline bool isRunning() const { return _running.load(std::memory_order_relaxed); }
+        /// \brief Take next message of any receiver (single consumer)
+        /// \details Workers are served in turn. Messages of one receiver keep their order
+        /// \param record Message copy with receiver index
+        /// \return \c false if no message is waiting
+        bool pop(PoolRecord& record);
+        /// \return Number of receivers
+        inline size_t size() const { return _count; }
+        /// \return Number of running workers
+        inline unsigned workers() const { return _active; }
+        /// \param link Receiver index
+        /// \return Receiver
+        inline BasicReceiver<Port>& receiver(const size_t link) { return *_links[link]; }
+        /// \return Number of messages dropped because a ring was full or the message did not fit into oem7::Record
+        inline uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    private:
+        /// \brief Worker loop
+        /// \param worker Worker index
+        void work(const unsigned worker);
+        /// \brief Parse bytes available at receiver
+        /// \param worker Worker index
+        /// \param link Receiver index
+        void drain(const unsigned worker, const size_t link);
+    private:
+        /// \brief Worker thread and its output
+        struct Worker {
+            std::thread thread;
+            Ring<PoolRecord, OEM7_POOL_RECORDS> records;
+        };
+        BasicReceiver<Port>* _links[OEM7_POOL_LINKS]{};
+        size_t _count{ 0 };
+        Worker _workers[OEM7_POOL_WORKERS];
+        unsigned _active{ 0 };
+        unsigned _next{ 0 };
+        std::atomic_bool _running{ false };
+        std::atomic<uint32_t> _dropped{ 0 };
+    };
+}
+
+#endif
+#endif // __OEM7_POOL_H__
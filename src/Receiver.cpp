@@ -4,187 +4,489 @@
 ///	\author     Oleksandr Ilushenko
 /// \date       2024
 #include "Receiver.h"
+#include "Log.h"
 
-#if defined(ESP8266) || defined(ESP32)
-# define xLog(fmt, ...) Serial.printf(fmt, ##__VA_ARGS__)
-# ifdef DEBUGLOG
-#  define xDebug(fmt, ...) Serial.printf("[%s %s:%i] ", __FUNCTION__, __FILENAME__, __LINE__); Serial.printf(fmt, ##__VA_ARGS__)
-# else
-#  define xDebug(fmt, ...)
-# endif
-#else
+#if !defined(ESP8266) && !defined(ESP32)
 # include <cstdio>
 # include <chrono>
 # include <thread>
-# define xLog(fmt, ...) printf(fmt, ##__VA_ARGS__)
-# ifdef DEBUGLOG
-#  ifdef _WIN32
-#   define __FILENAME__ (strrchr(__FILE__, '\\') ? strrchr(__FILE__, '\\') + 1 : __FILE__)
-#  else
-#   define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : __FILE__)
-#  endif // _WIN32
-#  define xDebug(fmt, ...) printf("[%s %s:%i] ", __FUNCTION__, __FILENAME__, __LINE__); printf(fmt, ##__VA_ARGS__)
-# else
-#  ifdef _WIN32
-#   pragma warning(push)
-#   pragma warning(disable : 4390)
-#  endif
-#  define xDebug(fmt, ...)
+# if OEM7_READER && defined(__linux__)
+#  include <pthread.h>
 # endif
 #endif
 
-oem7::Receiver::Receiver(SERIALPORT& serial) : _serial(serial)
+namespace {
+	/// \brief Output deferred log on scope exit: after parsing, off the frame handling path
+	struct LogFlush {
+		~LogFlush() { oem7::Log::flush(); }
+	};
+}
+
+#if !defined(ESP8266) && !defined(ESP32)
+namespace {
+	unsigned long millis()
+	{
+		auto duration = std::chrono::system_clock::now().time_since_epoch();
+		return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+	}
+
+	unsigned long micros()
+	{
+		auto duration = std::chrono::steady_clock::now().time_since_epoch();
+		return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+	}
+}
+#endif
+
+#if OEM7_FRAME_SIZE > 0
+template <typename Port>
+oem7::BasicReceiver<Port>::BasicReceiver(Port& port) : _port(port), _framer(&_storage[0], sizeof(_storage))
+{
+	_framer.onText(&BasicReceiver::onText, this);
+}
+#endif
+
+template <typename Port>
+oem7::BasicReceiver<Port>::BasicReceiver(Port& port, uint8_t* buffer, const size_t size) : _port(port), _framer(buffer, size)
 {
+	_framer.onText(&BasicReceiver::onText, this);
+	if (_framer.capacity() == 0) {
+		OEM7_LOG_E("Frame buffer %u is smaller than %u: no frames\n", static_cast<unsigned>(size), static_cast<unsigned>(Framer::MIN_SIZE));
+	}
+}
+
+template <typename Port>
+oem7::BasicReceiver<Port>::~BasicReceiver()
+{
+#if OEM7_READER
+	stopReader();
+#endif
 }
 
-void oem7::Receiver::begin()
+template <typename Port>
+void oem7::BasicReceiver<Port>::begin(const LogProfile& profile)
 {
-	setCommand("UNLOGALL TRUE");
+	setCommand(BinaryCommand::unlogAll(PORT_ALL, true));
+#if OEM7_MSG_VERSION
 	// Version
-	setCommand("LOG COM1 VERSIONB ONCE");
-	waitAvailable(100);
-	if (getData() != MSG_VERSION) {
-		_versionIdx = 0;
-		xDebug("#VERSION Read Error!\n");
+	_versionIdx = 0;
+	setCommand(BinaryCommand::log(profile.port, MSG_VERSION, TRIGGER_ONCE));
+	waitCommands();
+	const unsigned long ms = millis();
+	while (_versionIdx == 0 && millis() - ms <= 100) {
+		if (!waitAvailable(100)) break;
+		getData();
+	}
+	if (_versionIdx == 0) {
+		OEM7_LOG_D("#VERSION Read Error!\n");
+	}
+#endif
+	// Status events: RXSTATUS may then be a slow heartbeat
+	if (profile.events != nullptr && profile.has(MSG_RXSTATUSEVENT)) {
+		for (uint32_t word = WORD_STATUS; word <= WORD_AUX4; ++word) {
+			setCommand(BinaryCommand::statusConfig(STATUSCONFIG_SET, word, profile.events->mask[word]));
+			setCommand(BinaryCommand::statusConfig(STATUSCONFIG_CLEAR, word, profile.events->mask[word]));
+		}
 	}
 	// Log Messages
-	setCommand("LOG COM1 HWMONITORB ONTIME 1");
-	setCommand("LOG COM1 RXSTATUSB ONTIME 1");
-	setCommand("LOG COM1 TIMEB ONTIME 1");
-	setCommand("LOG COM1 BESTPOSB ONTIME 0.25");
-	setCommand("LOG COM1 DUALANTENNAHEADINGB ONTIME 0.25");
+	for (size_t i = 0; i < profile.count; ++i) {
+		const LogRequest& log = profile.logs[i];
+		setCommand(BinaryCommand::log(profile.port, log.msgId, log.trigger, log.period));
+	}
+	track(profile);
+	waitCommands();
 }
 
-void oem7::Receiver::stop()
+template <typename Port>
+oem7::StartKind oem7::BasicReceiver<Port>::warmStart(const LogProfile& profile, const bool configure, const char* key)
 {
-	setCommand("UNLOGALL TRUE");
+	const uint32_t hash = provisionHash(profile, configure);
+	WarmState cached;
+	if (WarmStore::load(key, cached) && cached.hash == hash) {
+		// Receiver still logging: the first profile log tells its build
+		track(profile);
+		_receiverVersion = 0;
+		bool logging = false;
+		const unsigned long ms = millis();
+		while (!logging && millis() - ms <= OEM7_WARM_WAIT) {
+			if (!waitAvailable(OEM7_WARM_WAIT)) break;
+			logging = (getData() & _subscribed) != 0 && _receiverVersion != 0;
+		}
+		if (logging && _receiverVersion == cached.receiverVersion) {
+#if OEM7_MSG_VERSION
+			const size_t count = sizeof(cached.version) / sizeof(cached.version[0]);
+			_versionIdx = cached.components < count ? cached.components : count;
+			memcpy(&_version[0], &cached.version[0], _versionIdx * sizeof(Version));
+#endif
+			OEM7_LOG_D("Warm start: build %u\n", static_cast<unsigned>(_receiverVersion));
+			return START_WARM;
+		}
+		// Receiver restarted: configuration saved by the same build is kept. The build is asked by a one-shot
+		// VERSION before begin(), so another build is provisioned by a single config() and begin() below
+		if (!logging && _receiverVersion == 0 && probe() && _receiverVersion == cached.receiverVersion) {
+			begin(profile);
+			OEM7_LOG_D("Warm start: subscribed, build %u\n", static_cast<unsigned>(_receiverVersion));
+			return START_SUBSCRIBE;
+		}
+	}
+	if (configure) config();
+	begin(profile);
+	saveWarm(key, hash);
+	return START_COLD;
 }
 
-void oem7::Receiver::update()
+template <typename Port>
+void oem7::BasicReceiver<Port>::track(const LogProfile& profile)
+{
+	_subscribed = 0;
+	for (size_t i = 0; i < profile.count; ++i) _subscribed |= flag(profile.logs[i].msgId);
+	_filter.reset();
+	_epochs.require(((_subscribed & GET_BESTPOS) ? EPOCH_POSITION : 0) | ((_subscribed & GET_HEADING) ? EPOCH_HEADING : 0));
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::saveWarm(const char* key, const uint32_t hash)
+{
+	// No response: nothing is known of the receiver
+	if (_receiverVersion == 0) return;
+	WarmState state;
+	state.hash = hash;
+	state.receiverVersion = _receiverVersion;
+#if OEM7_MSG_VERSION
+	const size_t count = sizeof(state.version) / sizeof(state.version[0]);
+	state.components = static_cast<uint16_t>(_versionIdx < count ? _versionIdx : count);
+	memcpy(&state.version[0], &_version[0], state.components * sizeof(Version));
+#endif
+	if (!WarmStore::save(key, state)) {
+		OEM7_LOG_W("Warm start: cache write error\n");
+	}
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::stop()
+{
+	setCommand(BinaryCommand::unlogAll(PORT_ALL, true));
+	waitCommands();
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::update()
+{
+	const LogFlush flush;
+	const unsigned long start = micros();
+	process();
+	_updateTime.add(static_cast<uint32_t>(micros() - start));
+	_updateLock.store(_updateTime);
+}
+
+template <typename Port>
+oem7::Estimate oem7::BasicReceiver<Port>::estimate() const
+{
+	return _filter.estimate(static_cast<uint32_t>(micros()));
+}
+
+template <typename Port>
+oem7::ReceiverStats oem7::BasicReceiver<Port>::stats() const
+{
+	ReceiverStats result = _statsLock.load();
+	result.update = _updateLock.load();
+#if OEM7_READER
+	result.overruns = dropped();
+#endif
+	return result;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::process()
 {
-	// Get Data Flag
-	enum {
-		GET_HWMONITOR	= 0x01,
-		GET_RXSTATUS	= 0x02,
-		GET_TIME		= 0x04,
-		GET_BESTPOS		= 0x08,
-		GET_HEADING		= 0x10
-	};
 	_valid = false;
-	uint8_t data = 0;
 	// Get Data
-	while (_serial.available() > 0) {
-		switch (getData()) {
-		case MSG_HWMONITOR:
-			data |= GET_HWMONITOR;
-			break;
-		case MSG_RXSTATUS:
-			data |= GET_RXSTATUS;
-			break;
-		case MSG_TIME:
-			data |= GET_TIME;
-			break;
-		case MSG_BESTPOS:
-			data |= GET_BESTPOS;
-			break;
-		case MSG_DUALANTHEADING:
-			data |= GET_HEADING;
-			break;
-		}		
-	}
+	uint32_t data = getData();
 	if (data == 0) return;
-	// Monitor
-	if ((data & GET_HWMONITOR)) {
-		for (uint32_t i = 0; i < _measurement; ++i) 
-			hardwareInfo(_monitor[i].boundary, _monitor[i].type, _monitor[i].value);
-	}
-	// Status
-	if ((data & GET_RXSTATUS)) {
-		if (_rxstatus.error != 0) {
-			statusInfo(WORD_ERROR, _rxstatus.error);
-			return;
-		}
-		statusInfo(WORD_STATUS, _rxstatus.rxstat);
-		statusInfo(WORD_AUX1, _rxstatus.aux1stat);
-		statusInfo(WORD_AUX2, _rxstatus.aux2stat);
-		statusInfo(WORD_AUX3, _rxstatus.aux3stat);
-		statusInfo(WORD_AUX4, _rxstatus.aux4stat);
+	// The latest epoch with all requested solution logs
+	const Epoch* epoch = _epochs.flush();
+	if (epoch != nullptr) {
+		if (epoch->logs & EPOCH_POSITION) _bestpos = epoch->position;
+		if (epoch->logs & EPOCH_HEADING) _heading = epoch->heading;
 	}
-	// Check Antenna 1
-	if (_rxstatus.rxstat & 0x00000008) return;		// Primary antenna power
-	if (_rxstatus.rxstat & 0x00000010) return;		// LNA Failure
-	if (_rxstatus.rxstat & 0x00000020) return;		// Primary antenna open circuit (disconnected)
-	if (_rxstatus.rxstat & 0x00000040) return;		// Primary antenna short circuit
-	if (_rxstatus.rxstat & 0x00004000) return;		// Antenna gain out of range
-	if (_rxstatus.aux3stat & 0x30) return;			// Antenna 1 gain out of range
-	// Check Antenna 2
-	if (_rxstatus.aux2stat & 0x10000000) return;	// Secondary antenna not powered
-	if (_rxstatus.aux2stat & 0x20000000) return;	// Secondary antenna open circuit (disconnected)
-	if (_rxstatus.aux2stat & 0x40000000) return;	// Secondary antenna short circuit
-	if (_rxstatus.aux3stat & 0xC0) return;			// Antenna 2 gain out of range
-	// Check RTK
-	if (_rxstatus.rxstat & 0x00040000) return;		// GPS almanac flag/UTC known
-	if (_rxstatus.rxstat & 0x00080000) return;		// Position solution invalid
-	if (_rxstatus.rxstat & 0x00400000) return;		// Clock model invalid
+	// Status: transitions only
+	if ((data & (GET_RXSTATUS | GET_RXEVENT))) {
+		_diagnostics.update(_rxstatus, &BasicReceiver::statusChange, this);
+		if (_rxstatus.error != 0) return;
+	}
+	if (!isHealthy(_rxstatus)) return;
 	// Time
 	if ((data & GET_TIME) && _time.clock_status == CLOCK_VALID && _time.utc_status == UTC_VALID) {
-		xDebug("#TIME[Status: %u, %04u-%02u-%02u %02u:%02u:%02u UTC]\n",
+		OEM7_LOG_D("#TIME[Status: %u, %04u-%02u-%02u %02u:%02u:%02u UTC]\n",
 			_time.clock_status, _time.utc_year, _time.utc_month, _time.utc_day,
 			_time.utc_hour, _time.utc_min, _time.utc_ms / 1000
 		);
 	}
 	// BestPos
 	if (data & GET_BESTPOS) {
-		xDebug("#BESTPOS[Status: %u, PosType: %u, lat: %0.9f, lon: %0.9f, alt: %.02f, SatView: %u, SatUsed: %u]\n",
+		OEM7_LOG_D("#BESTPOS[Status: %u, PosType: %u, lat: %0.9f, lon: %0.9f, alt: %.02f, SatView: %u, SatUsed: %u]\n",
 			_bestpos.solutionStatus, _bestpos.positionType,
 			_bestpos.lat, _bestpos.lon, _bestpos.alt,
 			_bestpos.satellitesTracked, _bestpos.satellitesUsed
 		);		
-		if (_bestpos.solutionStatus != SOL_COMPUTED) data &= ~GET_BESTPOS;
 	}
 	// Heading
 	if (data & GET_HEADING) {
-		xDebug("#HEADING[Status: %u, StatusEx: %02X, PosType: %u, Lenght: %.02f, Heading: %.02f, HeadingDev: %.02f Pitch: %.02f PitchDev: %.02f, SatView: %u, SatUsed: %u]\n",
+		OEM7_LOG_D("#HEADING[Status: %u, StatusEx: %02X, PosType: %u, Lenght: %.02f, Heading: %.02f, HeadingDev: %.02f Pitch: %.02f PitchDev: %.02f, SatView: %u, SatUsed: %u]\n",
 			_heading.solutionStatus, _heading.solutionStatusEx, _heading.positionType,
 			_heading.length, _heading.heading, _heading.hdgStdDev, _heading.pitch, _heading.ptchStdDev,
 			_heading.satellitesTracked, _heading.satellitesUsed
 		);
-		if (_heading.solutionStatus != SOL_COMPUTED) data &= ~GET_HEADING;
 	}
-	// Validation
-	if ((data & GET_BESTPOS) && (data & GET_HEADING)) {
-		_valid = (_heading.positionType == POS_NARROW_INT || _heading.positionType == POS_WIDE_INT || _heading.positionType == POS_NARROW_FLOAT);
+	// Rovers
+#if OEM7_LOG_LEVEL >= OEM7_LOG_DEBUG
+	if (data & GET_HEADING2) {
+		for (const Rover& rover : _rovers) {
+			OEM7_LOG_D("#HEADING2[Rover: %s, Status: %u, PosType: %u, Lenght: %.02f, Heading: %.02f, HeadingDev: %.02f, Updates: %u]\n",
+				rover.id, rover.heading.solutionStatus, rover.heading.positionType,
+				rover.heading.length, rover.heading.heading, rover.heading.hdgStdDev, rover.updates
+			);
+		}
+	}
+#endif
+	// Validation: requested solution logs of one epoch only
+	const uint32_t required = _subscribed & (GET_BESTPOS | GET_HEADING);
+	if (required != 0 && epoch != nullptr) {
+		const bool position = !(required & GET_BESTPOS) || _bestpos.solutionStatus == SOL_COMPUTED;
+		const bool heading = !(required & GET_HEADING) || _heading.solutionStatus == SOL_COMPUTED;
+		_valid = position && heading && isRtk((required & GET_HEADING) ? _heading.positionType : _bestpos.positionType);
 		//_valid = (_heading.positionType == POS_NARROW_INT);
 	}
 }
 
-void oem7::Receiver::reset()
+template <typename Port>
+bool oem7::BasicReceiver<Port>::isHealthy(const RxStatus& status)
+{
+	// Check Antenna 1
+	if (status.rxstat & 0x00000008) return false;	// Primary antenna power
+	if (status.rxstat & 0x00000010) return false;	// LNA Failure
+	if (status.rxstat & 0x00000020) return false;	// Primary antenna open circuit (disconnected)
+	if (status.rxstat & 0x00000040) return false;	// Primary antenna short circuit
+	if (status.rxstat & 0x00004000) return false;	// Antenna gain out of range
+	if (status.aux3stat & 0x30) return false;		// Antenna 1 gain out of range
+	// Check Antenna 2
+	if (status.aux2stat & 0x10000000) return false;	// Secondary antenna not powered
+	if (status.aux2stat & 0x20000000) return false;	// Secondary antenna open circuit (disconnected)
+	if (status.aux2stat & 0x40000000) return false;	// Secondary antenna short circuit
+	if (status.aux3stat & 0xC0) return false;		// Antenna 2 gain out of range
+	// Check RTK
+	if (status.rxstat & 0x00040000) return false;	// GPS almanac flag/UTC known
+	if (status.rxstat & 0x00080000) return false;	// Position solution invalid
+	if (status.rxstat & 0x00400000) return false;	// Clock model invalid
+	return true;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::applyEvent(RxStatus& status, const RxStatusEvent& event)
+{
+	if (event.bitmask >= 32) return;
+	// Bit location of the event, words are packed: no pointers to them
+	const uint32_t bit = static_cast<uint32_t>(1) << event.bitmask;
+	const uint32_t set = event.event ? bit : 0;
+	switch (event.word) {
+	case WORD_ERROR: status.error = (status.error & ~bit) | set; break;
+	case WORD_STATUS: status.rxstat = (status.rxstat & ~bit) | set; break;
+	case WORD_AUX1: status.aux1stat = (status.aux1stat & ~bit) | set; break;
+	case WORD_AUX2: status.aux2stat = (status.aux2stat & ~bit) | set; break;
+	case WORD_AUX3: status.aux3stat = (status.aux3stat & ~bit) | set; break;
+	case WORD_AUX4: status.aux4stat = (status.aux4stat & ~bit) | set; break;
+	}
+}
+
+template <typename Port>
+bool oem7::BasicReceiver<Port>::isRtk(const uint32_t positionType)
+{
+	return positionType == POS_NARROW_INT || positionType == POS_WIDE_INT || positionType == POS_NARROW_FLOAT;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::publish(const Frame& frame)
+{
+	Solution& sol = _solution;
+	switch (frame.id()) {
+	case MSG_BESTPOS: {
+		const MessageView<BestPos> pos(frame, MSG_BESTPOS);
+		if (!pos) {
+			count(frame.id(), &MessageStats::size);
+			return;
+		}
+		sol.positionWeek = pos.head().week;
+		sol.positionMs = pos.head().ms;
+		sol.positionReceived = frame.received;
+		sol.positionType = pos->positionType;
+		sol.positionValid = (pos->solutionStatus == SOL_COMPUTED);
+		sol.lat = pos->lat;
+		sol.lon = pos->lon;
+		sol.alt = pos->alt;
+		sol.latDev = pos->latStdDev;
+		sol.lonDev = pos->lonStdDev;
+		sol.altDev = pos->altStdDev;
+		break;
+	}
+	case MSG_DUALANTHEADING: {
+		const MessageView<DualAntHeading> hdg(frame, MSG_DUALANTHEADING);
+		if (!hdg) {
+			count(frame.id(), &MessageStats::size);
+			return;
+		}
+		sol.headingWeek = hdg.head().week;
+		sol.headingMs = hdg.head().ms;
+		sol.headingReceived = frame.received;
+		sol.headingType = hdg->positionType;
+		sol.headingValid = (hdg->solutionStatus == SOL_COMPUTED);
+		sol.heading = hdg->heading;
+		sol.headingDev = hdg->hdgStdDev;
+		sol.pitch = hdg->pitch;
+		sol.pitchDev = hdg->ptchStdDev;
+		sol.length = hdg->length;
+		sol.satellitesTracked = hdg->satellitesTracked;
+		sol.satellitesUsed = hdg->satellitesUsed;
+		break;
+	}
+	case MSG_RXSTATUS: {
+		const MessageView<RxStatus> status(frame, MSG_RXSTATUS);
+		if (!status) {
+			count(frame.id(), &MessageStats::size);
+			return;
+		}
+		_health = *status;
+		sol.healthy = (_health.error == 0) && isHealthy(_health);
+		break;
+	}
+	case MSG_RXSTATUSEVENT: {
+		const MessageView<RxStatusEvent> event(frame, MSG_RXSTATUSEVENT);
+		if (!event) {
+			count(frame.id(), &MessageStats::size);
+			return;
+		}
+		applyEvent(_health, *event);
+		sol.healthy = (_health.error == 0) && isHealthy(_health);
+		break;
+	}
+	default:
+		return;
+	}
+	// Requested solution logs only, of one epoch if both are requested
+	const bool position = !(_subscribed & GET_BESTPOS) || sol.positionValid;
+	const bool heading = !(_subscribed & GET_HEADING) || sol.headingValid;
+	const bool rtk = isRtk((_subscribed & GET_HEADING) ? sol.headingType : sol.positionType);
+	const bool epoch = (~_subscribed & (GET_BESTPOS | GET_HEADING)) != 0 ||
+		(sol.positionWeek == sol.headingWeek && sol.positionMs == sol.headingMs);
+	sol.valid = sol.healthy && (_subscribed & (GET_BESTPOS | GET_HEADING)) != 0 && position && heading && rtk && epoch;
+	_latest.store(sol);
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::reset()
 {
 	// Factory Reset
 #if defined(ESP8266) || defined(ESP32)
+	const uint32_t baud = _port.baudRate();
 	setCommand("FRESET STANDARD");
+	waitCommands();
 	delay(5000);
 	// Default baud rate
-	_serial.begin(9600, SERIAL_8N1, 5, 18);
+	setBaud(9600);
 	// Restore baud rate
-	setCommand("UNLOGALL TRUE");
-	setCommand("SERIALCONFIG COM1 115200 N 8 1 N ON");
+	setCommand(BinaryCommand::unlogAll(PORT_ALL, true));
+	setCommand(BinaryCommand::serialConfig(COMPORT_COM1, baud));
+	waitCommands();
 	delay(1000);
-	_serial.begin(115200, SERIAL_8N1, 5, 18);
+	setBaud(baud);
 	setCommand("SAVECONFIG");
+	waitCommands();
 #endif
 }
 
-void oem7::Receiver::config()
+template <typename Port>
+uint32_t oem7::BasicReceiver<Port>::negotiate(const uint32_t maxBaud)
+{
+	static const uint32_t rates[] = { 921600, 460800, 230400, 115200, 57600, 38400, 19200, 9600 };
+	const size_t count = sizeof(rates) / sizeof(rates[0]);
+	// Current rate: OEM7 default and the common ones first
+	static const uint8_t order[] = { 3, 0, 1, 2, 7, 4, 5, 6 };
+	size_t current = count;
+	for (size_t i = 0; i < count && current == count; ++i) {
+		if (setBaud(rates[order[i]]) && probe()) current = order[i];
+	}
+	if (current == count) {
+		OEM7_LOG_D("Baud negotiation: no response\n");
+		return 0;
+	}
+	OEM7_LOG_D("Baud negotiation: current %u\n", static_cast<unsigned>(rates[current]));
+	// Step up: the fastest clean rate wins
+	for (size_t i = 0; i < current; ++i) {
+		if (rates[i] > maxBaud) continue;
+		if (stepBaud(rates[current], rates[i])) return rates[i];
+	}
+	return rates[current];
+}
+
+template <typename Port>
+bool oem7::BasicReceiver<Port>::setBaud(const uint32_t baud)
+{
+	if (!_port.setBaud(baud)) return false;
+	// Bytes received at the old rate are garbage
+	_framer.reset();
+	_rxPos = 0;
+	_rxLen = 0;
+	return true;
+}
+
+template <typename Port>
+bool oem7::BasicReceiver<Port>::probe()
+{
+	// Response frame passed the CRC: the binary link is clean. Logged to the port the command came on
+	CommandStatus status = CMD_TIMEOUT;
+	if (!sendCommand(BinaryCommand::log(PORT_THISPORT, MSG_VERSION, TRIGGER_ONCE), &BasicReceiver::storeStatus, &status, 250)) return false;
+	waitCommands();
+	return status == CMD_OK;
+}
+
+template <typename Port>
+bool oem7::BasicReceiver<Port>::stepBaud(const uint32_t from, const uint32_t to)
+{
+	// Reply may come at either rate, so it is not checked. THISPORT: the receiver port the serial is wired to
+	sendCommand(BinaryCommand::serialConfig(COMPORT_THISPORT, to), nullptr, nullptr, 250);
+	waitCommands();
+	if (setBaud(to) && probe()) {
+		OEM7_LOG_D("Baud negotiation: %u\n", static_cast<unsigned>(to));
+		return true;
+	}
+	// Receiver kept the old rate
+	if (setBaud(from) && probe()) return false;
+	// Receiver switched, but the link is not clean: switch it back
+	if (setBaud(to)) {
+		sendCommand(BinaryCommand::serialConfig(COMPORT_THISPORT, from), nullptr, nullptr, 250);
+		waitCommands();
+	}
+	setBaud(from);
+	probe();
+	return false;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::storeStatus(const CommandResult& result, void* context)
+{
+	*static_cast<CommandStatus*>(context) = result.status;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::config()
 {
-	setCommand("UNLOGALL TRUE");
+	setCommand(BinaryCommand::unlogAll(PORT_ALL, true));
 	// Antenna config (Talysman TW3972XF)
-	setCommand("ANTENNATYPE REMOVE USER_ANTENNA_1");
-	setCommand("ANTENNATYPE REMOVE USER_ANTENNA_2");
-	setCommand("ANTENNATYPE REMOVE USER_ANTENNA_3");
-	setCommand("ANTENNATYPE REMOVE USER_ANTENNA_4");
-	setCommand("ANTENNATYPE REMOVE USER_ANTENNA_5");
-	// TW3972XF
+	setCommand(BinaryCommand::antennaRemove(USER_ANTENNA_1));
+	setCommand(BinaryCommand::antennaRemove(USER_ANTENNA_2));
+	setCommand(BinaryCommand::antennaRemove(USER_ANTENNA_3));
+	setCommand(BinaryCommand::antennaRemove(USER_ANTENNA_4));
+	setCommand(BinaryCommand::antennaRemove(USER_ANTENNA_5));
+	// TW3972XF: ASCII is shorter than binary offsets and patterns (doubles)
 	setCommand("ANTENNATYPE ADD USER_ANTENNA_1 TW3972XF 13"
 		" GPSL1 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0"
 		" GPSL2 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0 0.0"
@@ -206,206 +508,437 @@ void oem7::Receiver::config()
 	setCommand("DUALANTENNAALIGN ENABLE 5 5");
 	// Assigns all channels of a satellite system
 	setCommand("ASSIGNALL ALL AUTO");
-	// Priority no event
-	setCommand("STATUSCONFIG PRIORITY STATUS 0");
-	setCommand("STATUSCONFIG PRIORITY AUX1 0");
-	setCommand("STATUSCONFIG PRIORITY AUX2 0");
-	setCommand("STATUSCONFIG PRIORITY AUX3 0");
-	setCommand("STATUSCONFIG PRIORITY AUX4 0");
-	// Set no event
-	setCommand("STATUSCONFIG SET STATUS 0");
-	setCommand("STATUSCONFIG SET AUX1 0");
-	setCommand("STATUSCONFIG SET AUX2 0");
-	setCommand("STATUSCONFIG SET AUX3 0");
-	setCommand("STATUSCONFIG SET AUX4 0");
-	// Clear no event
-	setCommand("STATUSCONFIG CLEAR STATUS 0");
-	setCommand("STATUSCONFIG CLEAR AUX1 0");
-	setCommand("STATUSCONFIG CLEAR AUX2 0");
-	setCommand("STATUSCONFIG CLEAR AUX3 0");
-	setCommand("STATUSCONFIG CLEAR AUX4 0");
+	// Priority, set and clear masks: no event (begin() sets the masks of an event profile)
+	for (uint32_t type = STATUSCONFIG_PRIORITY; type <= STATUSCONFIG_CLEAR; ++type) {
+		for (uint32_t word = WORD_STATUS; word <= WORD_AUX4; ++word) setCommand(BinaryCommand::statusConfig(type, word, 0));
+	}
 	// Configure the sensitivity level for the Jammer Detected bit: 0 = most sensitive, 3 = least sensitive
 	setCommand("ITWARNINGCONFIG 1");
 	// Save Configuration
 	setCommand("SAVECONFIG");
+	waitCommands();
 }
 
-void oem7::Receiver::setCommand(const char *cmd)
+template <typename Port>
+void oem7::BasicReceiver<Port>::setCommand(const char *cmd)
 {
-	// Write Abbreviated ASCII Command.
-#if defined(ESP8266) || defined(ESP32)
-	_serial.write(cmd, strlen(cmd));
-	_serial.write("\n", 1);
-#else
-	_serial.writeBytes(cmd, strlen(cmd));
-	_serial.writeBytes("\n", 1);
-	auto yield = [&]() {
-#ifdef WIN32
-		::Sleep(0);
-#else
-		usleep(0);
-#endif
-	};
-#endif
-	xLog(">%s\n", cmd);
-	// Read Abbreviated ASCII Response. Example: \r\n<OK\r\n[COM1]
-	if (!waitAvailable(100)) return;
-	uint8_t data = 0;
-	while (_serial.available() > 0) {
-		if (_serial.readBytes(&data, 1) != 1) continue;
-		if (data != 0x0D && data != 0x0A) xLog("%c", data);
-		if (data == ']') break;
-	}
-	xLog("\n");
+	OEM7_LOG_I(">%s\n", cmd);
+	// Queue is full: wait for the oldest replies
+	while (!_commands.push(cmd, &BasicReceiver::logCommand, nullptr, OEM7_COMMAND_TIMEOUT)) pump();
+	service();
 }
 
-uint16_t oem7::Receiver::getData()
+template <typename Port>
+void oem7::BasicReceiver<Port>::setCommand(const BinaryCommand& cmd)
 {
-	static Head head = { 0 };
-	static uint8_t crcbuf[4] = { 0 };
-	static uint8_t buffer[1024] = { 0 };
-	// 0xAA Sync Byte
-	if (_serial.readBytes(&buffer[0], 1) != 1) {
-		xLog("Error read byte\n");
-		return 0;
-	}
-	//xDebug("1 0x%02X %c\n", buffer[0], buffer[0]);
-	if (buffer[0] != HEAD_SYNC_1) return 0;
-	// 0x44 Sync Byte
-	if (_serial.readBytes(&buffer[1], 1) != 1) {
-		xLog("Error read byte\n");
-		return 0;
-	}
-	//xDebug("2 0x%02X %c\n", buffer[1], buffer[1]);
-	if (buffer[1] != HEAD_SYNC_2) return 0;
-	// 0x12 Sync Byte
-	if (_serial.readBytes(&buffer[2], 1) != 1) {
-		xLog("Error read byte\n");
-		return 0;
+	OEM7_LOG_I(">#%u\n", cmd.msgId);
+	// Queue is full: wait for the oldest replies
+	while (!_commands.push(cmd, &BasicReceiver::logCommand, nullptr, OEM7_COMMAND_TIMEOUT)) pump();
+	service();
+}
+
+template <typename Port>
+bool oem7::BasicReceiver<Port>::sendCommand(const char* cmd, CommandHandler fn, void* context, const unsigned long timeout)
+{
+	if (!_commands.push(cmd, fn, context, timeout)) return false;
+	service();
+	return true;
+}
+
+template <typename Port>
+bool oem7::BasicReceiver<Port>::sendCommand(const BinaryCommand& cmd, CommandHandler fn, void* context, const unsigned long timeout)
+{
+	if (!_commands.push(cmd, fn, context, timeout)) return false;
+	service();
+	return true;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::waitCommands()
+{
+	while (!_commands.empty()) pump();
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::service()
+{
+	_commands.expire(millis());
+	for (const CommandQueue::Entry* cmd = _commands.next(); cmd != nullptr; cmd = _commands.next()) {
+		if (cmd->command != nullptr) {
+			// Write Abbreviated ASCII Command.
+			_port.write(reinterpret_cast<const uint8_t*>(cmd->command), strlen(cmd->command));
+			_port.write(reinterpret_cast<const uint8_t*>("\n"), 1);
+		} else {
+			// Write Binary Command
+			uint8_t data[HEAD_LENGHT + OEM7_COMMAND_BODY + sizeof(uint32_t)];
+			const size_t size = cmd->binary.encode(&data[0], sizeof(data));
+			_port.write(&data[0], size);
+		}
+		_commands.sent(millis());
 	}
-	//xDebug("3 0x%02X %c\n", buffer[2], buffer[2]);
-	if (buffer[2] != HEAD_SYNC_3) return 0;
-	// 0x1C Head Size
-	if (_serial.readBytes(&buffer[3], 1) != 1) {
-		xLog("Error read byte\n");
-		return 0;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::pump()
+{
+	// Command echoes and replies are output while waiting
+	const LogFlush flush;
+	Frame frame;
+	if (read(frame)) cache(frame);
+	else if (!_commands.empty()) waitAvailable(10);
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::onText(const uint8_t* data, size_t size, void* context)
+{
+	static_cast<BasicReceiver*>(context)->_commands.text(data, size);
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::logCommand(const CommandResult& result, void* context)
+{
+	// Read Abbreviated ASCII Response. Example: \r\n<OK\r\n[COM1]
+	(void)context;
+	if (result.status == CMD_TIMEOUT) {
+		if (result.command != nullptr) OEM7_LOG_W("<TIMEOUT %.32s\n", result.command);
+		else OEM7_LOG_W("<TIMEOUT #%u\n", result.msgId);
+		return;
 	}
-	//xDebug("4 0x%02X %c\n", buffer[3], buffer[3]);
-	if (buffer[3] != HEAD_LENGHT) {
-		xLog("Head Size Wrong: %i\n", static_cast<int>(buffer[3]));
-		return 0;
+	if (result.status == CMD_ERROR) {
+		if (result.command != nullptr) OEM7_LOG_W("<%s\n", result.reply);
+		else OEM7_LOG_W("<%s #%u\n", result.reply, result.msgId);
+		return;
 	}
-	// Read Header
-	if (_serial.readBytes(&buffer[4], sizeof(Head)) != sizeof(Head)) {
-		xLog("Head Read Error\n");
-		return 0;
+	if (result.command != nullptr) OEM7_LOG_I("<%s\n", result.reply);
+	else OEM7_LOG_I("<OK #%u\n", result.msgId);
+}
+
+template <typename Port>
+bool oem7::BasicReceiver<Port>::read(Frame& frame)
+{
+	if (!_commands.empty()) service();
+	const unsigned long start = micros();
+	bool refill = true;
+	for (;;) {
+		if (_rxPos == _rxLen && !_framer.pending()) {
+			// Bulk reads of bytes available now: never waits for the rest of a frame.
+			// A short read drained the port, a full one may have left bytes in it
+			if (!refill) {
+				publishStats();
+				return false;
+			}
+			const int n = _port.read(&_rx[0], sizeof(_rx));
+			refill = n == static_cast<int>(sizeof(_rx));
+			if (n == 0) {
+				publishStats();
+				return false;
+			}
+			if (n < 0) {
+				OEM7_LOG_E("Error read bytes\n");
+				++_stats.readErrors;
+				_statsDirty = true;
+				publishStats();
+				return false;
+			}
+			_rxTime = static_cast<uint32_t>(micros());
+			_rxPos = 0;
+			_rxLen = static_cast<size_t>(n);
+			if (_capture != nullptr) _capture->add(_rxTime, &_rx[0], _rxLen);
+		}
+		_rxPos += _framer.parse(&_rx[_rxPos], _rxLen - _rxPos);
+		switch (_framer.status()) {
+		case Framer::FRAME_READY:
+			frame = _framer.frame();
+			frame.received = _rxTime;
+			if (!frame.isShort()) _receiverVersion = frame.head->receiverVersion;
+			++_stats.frames;
+			count(frame.id(), &MessageStats::received);
+			_statsDirty = true;
+			// Binary command response
+			if (frame.head->msgType & MSGTYPE_RESPONSE) {
+				_commands.response(frame);
+				break;
+			}
+			measure(frame);
+			_dispatcher.dispatch(frame);
+			publish(frame);
+			_stats.parse.add(static_cast<uint32_t>(micros() - start));
+			return true;
+		case Framer::FRAME_HEAD_SIZE:
+			OEM7_LOG_W("Head Size Wrong\n");
+			++_stats.headSize;
+			_statsDirty = true;
+			break;
+		case Framer::FRAME_OVERSIZE:
+			OEM7_LOG_D("Message Size Wrong: %u\n", static_cast<unsigned>(_framer.size()));
+			++_stats.oversize;
+			// ID of a rejected header may be random: it takes no slot
+			count(_framer.head().msgId, &MessageStats::size, false);
+			_statsDirty = true;
+			break;
+		case Framer::FRAME_CRC:
+			OEM7_LOG_D("CRC Error! Contain: %u Computed: %u\n", _framer.crc(), _framer.computed());
+			++_stats.crc;
+			count(_framer.head().msgId, &MessageStats::crc, false);
+			_statsDirty = true;
+			break;
+		default:
+			break;
+		}
 	}
-	memcpy(&head, &buffer[4], sizeof(Head));
-	const size_t size = static_cast<size_t>(head.msgLenght);
-	//xDebug("Msg ID: %u Size: %u\n", head.msgId, size);
-	// Read Message
-	if (_serial.readBytes(&buffer[HEAD_LENGHT], size) != size) {
-		xDebug("Message Read Error\n");
-		return 0;
+}
+
+template <typename Port>
+size_t oem7::BasicReceiver<Port>::feed(const uint8_t* data, const size_t size, const uint32_t time)
+{
+	if (_rxPos < _rxLen) return 0;
+	const size_t n = size < sizeof(_rx) ? size : sizeof(_rx);
+	memcpy(&_rx[0], data, n);
+	_rxTime = time;
+	_rxPos = 0;
+	_rxLen = n;
+	return n;
+}
+
+template <typename Port>
+uint32_t oem7::BasicReceiver<Port>::replay(CaptureReader& reader, const bool realtime)
+{
+	CaptureChunk chunk;
+	uint32_t records = 0;
+	uint32_t first = 0;
+	const unsigned long start = micros();
+	while (reader.next(chunk)) {
+		if (records++ == 0) first = chunk.time;
+		// Original speed: wait until the record is due
+		while (realtime && static_cast<int32_t>((chunk.time - first) - static_cast<uint32_t>(micros() - start)) > 1000) {
+#if defined(ESP8266) || defined(ESP32)
+			delay(1);
+#else
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#endif
+		}
+		for (size_t used = 0; used < chunk.size; ) {
+			used += feed(&chunk.data[used], chunk.size - used, chunk.time);
+			update();
+		}
 	}
-	// Read CRC
-	if (_serial.readBytes(&crcbuf[0], sizeof(uint32_t)) != sizeof(uint32_t)) {
-		xDebug("CRC Read Error\n");
-		return 0;
+	return records;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::count(const uint16_t msgId, uint32_t MessageStats::* counter, const bool allocate)
+{
+	MessageStats* message = allocate ? _stats.message(msgId) : _stats.find(msgId);
+	if (message != nullptr) ++(message->*counter);
+	else ++_stats.other;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::measure(const Frame& frame)
+{
+	// Short header has no idle time and no time status
+	if (frame.isShort()) return;
+	_stats.idle = frame.head->idleTime;
+	if (_stats.idle < _stats.idleMin) _stats.idleMin = _stats.idle;
+	// Epoch of the header is meaningful with fine GPS time only
+	const uint8_t time = frame.head->timeStatus;
+	if (time < GPSTIME_FINEADJUSTING || time == GPSTIME_SATTIME) return;
+	const uint32_t us = _clock.latency(frame.head->week, frame.head->ms, frame.received);
+	_stats.latency.add(us);
+	MessageStats* message = _stats.message(frame.id());
+	if (message != nullptr) message->latency = us;
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::publishStats()
+{
+	// Once per drained batch, not per frame
+	if (!_statsDirty && _stats.discarded == static_cast<uint32_t>(_framer.discarded())) return;
+	_stats.discarded = static_cast<uint32_t>(_framer.discarded());
+	_statsLock.store(_stats);
+	_statsDirty = false;
+}
+
+template <typename Port>
+uint32_t oem7::BasicReceiver<Port>::getData()
+{
+	uint32_t data = 0;
+#if OEM7_READER
+	// Messages decoded by the background reader
+	if (_reading.load(std::memory_order_relaxed)) {
+		Record record;
+		while (_records.pop(record)) data |= flag(cache(record.frame()));
+		return data;
 	}
-	uint32_t crc = 0;
-	memcpy(&crc, &crcbuf[0], sizeof(crc));
-	// Check CRC
-	const uint32_t chk = crc32(&buffer[0], size + HEAD_LENGHT);
-	if (crc != chk) {
-		xDebug("CRC Error! Contain: %u Computed: %u\n", crc, chk);
+#endif
+	Frame frame;
+	while (read(frame)) data |= flag(cache(frame));
+	return data;
+}
+
+template <typename Port>
+uint16_t oem7::BasicReceiver<Port>::cache(const Frame& frame)
+{
+	const MessageInfo* info = Messages::find(frame.id());
+	// Logs out of the profile are not copied
+	if (info != nullptr && !(info->flag & (_subscribed | GET_VERSION))) return 0;
+	if (!frame.isShort()) _idleTime = frame.head->idleTime;
+	if (info == nullptr) return frame.id();
+	if (!info->accepts(frame.body, frame.size)) {
+		OEM7_LOG_D("%s Wrong Size\n", info->name);
 		return 0;
 	}
 	// to Data
-	switch (head.msgId) {
-	case MSG_VERSION:
-		if (size < sizeof(uint32_t)) {
-			xDebug("OEM7Version Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_versionIdx, &buffer[HEAD_LENGHT], sizeof(uint32_t));
-		//xDebug("OEM7Version Number: %u\n", _versionIdx);
-		if (size - sizeof(uint32_t) != _versionIdx * sizeof(Version)) {
-			xDebug("OEM7Version Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_version[0], &buffer[HEAD_LENGHT + sizeof(uint32_t)], size - sizeof(uint32_t));
-		break;
-	case MSG_HWMONITOR:
-		if (size < sizeof(uint32_t)) {
-			xDebug("OEM7HWMonitor Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_measurement, &buffer[HEAD_LENGHT], sizeof(uint32_t));
-		//xDebug("OEM7HWMonitor Number: %u\n", _measurement);
-		if (size - sizeof(uint32_t) != _measurement * sizeof(HWMonitor)) {
-			xDebug("OEM7HWMonitor Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_monitor[0], &buffer[HEAD_LENGHT + sizeof(uint32_t)], size - sizeof(uint32_t));
-		break;
-	case MSG_RXSTATUS:
-		if (size != sizeof(oem7::RxStatus)) {
-			xDebug("OEM7RxStatus Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_rxstatus, &buffer[HEAD_LENGHT], size);
-		break;
-	case MSG_RXSTATUSEVENT:
-		if (size != sizeof(oem7::RxStatusEvent)) {
-			xDebug("OEM7RxStatusEvent Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_event, &buffer[HEAD_LENGHT], size);
-		break;
-	case MSG_TIME:
-		if (size != sizeof(oem7::Time)) {
-			xDebug("OEM7Time Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_time, &buffer[HEAD_LENGHT], size);
-		break;
-	case MSG_BESTPOS:
-		if (size != sizeof(oem7::BestPos)) {
-			xDebug("OEM7BestPos Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_bestpos, &buffer[HEAD_LENGHT], size);
-		break;
-	case MSG_DUALANTHEADING:
-		if (size != sizeof(oem7::DualAntHeading)) {
-			xDebug("OEM7DualAntHeading Wrong Size\n");
-			return 0;
-		}
-		memcpy(&_heading, &buffer[HEAD_LENGHT], size);
+	auto copy = [this, &frame](auto tag) { store(tag, frame); };
+	Messages::dispatch(*info, copy);
+	return frame.id();
+}
+
+#if OEM7_MSG_VERSION
+template <typename Port>
+void oem7::BasicReceiver<Port>::store(MessageTag<Version>, const Frame& frame)
+{
+	memcpy(&_versionIdx, &frame.body[0], sizeof(uint32_t));
+	memcpy(&_version[0], &frame.body[sizeof(uint32_t)], frame.size - sizeof(uint32_t));
+}
+#endif
+
+#if OEM7_MSG_HWMONITOR
+template <typename Port>
+void oem7::BasicReceiver<Port>::store(MessageTag<HWMonitor>, const Frame& frame)
+{
+	memcpy(&_measurement, &frame.body[0], sizeof(uint32_t));
+	memcpy(&_monitor[0], &frame.body[sizeof(uint32_t)], frame.size - sizeof(uint32_t));
+	// Boundary transitions only are logged
+	_hardware.update(*frame.head, &_monitor[0], _measurement, frame.received, &BasicReceiver::hardwareChange, this);
+}
+#endif
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::store(MessageTag<RxStatus>, const Frame& frame)
+{
+	memcpy(&_rxstatus, &frame.body[0], frame.size);
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::store(MessageTag<RxStatusEvent>, const Frame& frame)
+{
+	memcpy(&_event, &frame.body[0], frame.size);
+	// Status between RXSTATUS heartbeats
+	applyEvent(_rxstatus, _event);
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::store(MessageTag<Time>, const Frame& frame)
+{
+	memcpy(&_time, &frame.body[0], frame.size);
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::store(MessageTag<BestPos>, const Frame& frame)
+{
+	memcpy(&_bestpos, &frame.body[0], frame.size);
+	if (_bestpos.solutionStatus == SOL_COMPUTED) _filter.position(_bestpos, frame.received);
+	_epochs.add(frame);
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::store(MessageTag<DualAntHeading>, const Frame& frame)
+{
+	memcpy(&_heading, &frame.body[0], frame.size);
+	if (_heading.solutionStatus == SOL_COMPUTED) _filter.heading(_heading, frame.received);
+	_epochs.add(frame);
+}
+
+#if OEM7_MSG_HEADING2
+template <typename Port>
+void oem7::BasicReceiver<Port>::store(MessageTag<Heading2>, const Frame& frame)
+{
+	Heading2 heading;
+	memcpy(&heading, &frame.body[0], frame.size);
+	// Full table is reported once
+	if (_rovers.update(*frame.head, heading, frame.received) == nullptr && _rovers.overflow() == 1) {
+		OEM7_LOG_W("HEADING2 rover table is full, see OEM7_ROVERS\n");
 	}
-	return head.msgId;
 }
+#endif
 
-bool oem7::Receiver::waitAvailable(const unsigned long timeout) const
+template <typename Port>
+bool oem7::BasicReceiver<Port>::waitAvailable(const unsigned long timeout)
 {
-#if !defined(ESP8266) && !defined(ESP32)
-	auto millis = []() {
-		auto duration = std::chrono::system_clock::now().time_since_epoch();
-		return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
-	};
-	auto yield = []() { std::this_thread::yield(); };
+	return _rxPos < _rxLen || _port.wait(timeout);
+}
+
+#if OEM7_READER
+template <typename Port>
+bool oem7::BasicReceiver<Port>::startReader(const int core, const unsigned priority)
+{
+	if (_reading.exchange(true)) return false;
+#if defined(ESP32)
+	_readerDone.store(false);
+	const BaseType_t cpu = (core < 0) ? tskNO_AFFINITY : static_cast<BaseType_t>(core);
+	if (xTaskCreatePinnedToCore(&BasicReceiver::readerTask, "oem7", OEM7_READER_STACK, this, priority, nullptr, cpu) != pdPASS) {
+		_readerDone.store(true);
+		_reading.store(false);
+		return false;
+	}
+#else
+	(void)priority;
+	_thread = std::thread(&BasicReceiver::reader, this);
+	if (core >= 0) {
+#if defined(_WIN32)
+		::SetThreadAffinityMask(_thread.native_handle(), static_cast<DWORD_PTR>(1) << core);
+#elif defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(core, &set);
+		pthread_setaffinity_np(_thread.native_handle(), sizeof(set), &set);
 #endif
-	unsigned long ms = millis();
-	if (static_cast<unsigned long>(ms + timeout) == 0) ms = 0;
-	while (_serial.available() == 0) {
-		if (millis() - ms > timeout) return false;
-		yield();
 	}
+#endif
 	return true;
 }
 
-void oem7::Receiver::hardwareInfo(const uint8_t boundary, const uint8_t type, const float value)
+template <typename Port>
+void oem7::BasicReceiver<Port>::stopReader()
+{
+	if (!_reading.exchange(false)) return;
+#if defined(ESP32)
+	while (!_readerDone.load()) vTaskDelay(1);
+#else
+	if (_thread.joinable()) _thread.join();
+#endif
+}
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::reader()
+{
+	Frame frame;
+	Record record;
+	while (_reading.load(std::memory_order_relaxed)) {
+		if (read(frame)) {
+			if (!record.assign(frame) || !_records.push(record)) _dropped.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+		// Nothing to parse: sleep until data arrives, wake up periodically to check stop request
+		waitAvailable(10);
+	}
+}
+
+#if defined(ESP32)
+template <typename Port>
+void oem7::BasicReceiver<Port>::readerTask(void* arg)
+{
+	BasicReceiver* self = static_cast<BasicReceiver*>(arg);
+	self->reader();
+	self->_readerDone.store(true);
+	vTaskDelete(nullptr);
+}
+#endif
+#endif
+
+template <typename Port>
+void oem7::BasicReceiver<Port>::hardwareInfo(const uint8_t boundary, const uint8_t type, const float value)
 {
 	auto limit = [&]() {
 		switch (boundary) {
@@ -417,151 +950,98 @@ void oem7::Receiver::hardwareInfo(const uint8_t boundary, const uint8_t type, co
 		}
 		return "unknown";
 	};
+	(void)limit;
+	(void)value;
 	switch (type) {
 	case HW_RESERVED: return;
 	case HW_TEMPERATURE1:
-		xLog("#HW Temperature: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Temperature: %f - %s\n", value, limit());
 		break;
 	case HW_A1_AMPERAGE:
-		xLog("#HW Antenna Current: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Antenna Current: %f - %s\n", value, limit());
 		break;
 	case HW_CORE_3V3:
-		xLog("#HW Digital Core 3V3 Voltage: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Digital Core 3V3 Voltage: %f - %s\n", value, limit());
 		break;
 	case HW_A1_VOLTAGE:
-		xLog("#HW Antenna Voltage: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Antenna Voltage: %f - %s\n", value, limit());
 		break;
 	case HW_CORE_1V2:
-		xLog("#HW Digital 1V2 Core Voltage: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Digital 1V2 Core Voltage: %f - %s\n", value, limit());
 		break;
 	case HW_SUPPLY_VOLTAGE:
-		xLog("#HW Regulated Supply Voltage: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Regulated Supply Voltage: %f - %s\n", value, limit());
 		break;
 	case HW_CORE_1V8:
-		xLog("#HW Digital 1V8 Core Voltage: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Digital 1V8 Core Voltage: %f - %s\n", value, limit());
 		break;
 	case HW_CORE_5V:
-		xLog("#HW 5V Voltage: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW 5V Voltage: %f - %s\n", value, limit());
 		break;
 	case HW_TEMPERATURE2:
-		xLog("#HW Secondary Temperature: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Secondary Temperature: %f - %s\n", value, limit());
 		break;
 	case HW_PERIPHERAL:
-		xLog("#HW Peripheral Core Voltage: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Peripheral Core Voltage: %f - %s\n", value, limit());
 		break;
 	case HW_A2_AMPERAGE:
-		xLog("#HW Secondary Antenna Current: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Secondary Antenna Current: %f - %s\n", value, limit());
 		break;
 	case HW_A2_VOLTAGE:
-		xLog("#HW Secondary Antenna Voltage: %f - %s\n", value, limit());
+		OEM7_LOG_I("#HW Secondary Antenna Voltage: %f - %s\n", value, limit());
 		break;
 	}
 }
 
-void oem7::Receiver::statusInfo(const uint8_t word, const uint32_t bitmask)
+template <typename Port>
+void oem7::BasicReceiver<Port>::statusChange(const StatusChange& change, void* context)
 {
-	const char** msg = nullptr;
-	switch (word) {
-	case WORD_ERROR:
-		msg = txterror;
-		break;
-	case WORD_STATUS:
-		msg = txtstatus;
-		// Version Bits
-		switch (bitmask & 0x06000000) {
-		case 0x00:
-			xLog("#STATUS: Interpret Status/Error Bits as OEM6 or earlier format\n");
-			break;
-		case 0x02000000:
-			xLog("#STATUS: Interpret Status/Error Bits as OEM7 format\n");
-			break;
-		case 0x04000000:
-		case 0x06000000:
-			xLog("#STATUS: Reserved for a future version\n");
-			break;
-		}
+#if OEM7_STATUS_TEXT
+	switch (change.severity) {
+	case SEVERITY_ERROR:
+		OEM7_LOG_E("%s ERROR: %s%s\n", change.name, change.set ? "" : "Cleared: ", change.text);
 		break;
-	case WORD_AUX1:
-		msg = txtaux1;
+	case SEVERITY_WARNING:
+		OEM7_LOG_W("%s WARNING: %s%s\n", change.name, change.set ? "" : "Cleared: ", change.text);
 		break;
-	case WORD_AUX2:
-		msg = txtaux2;
+	default:
+		OEM7_LOG_I("%s: %s%s\n", change.name, change.set ? "" : "Cleared: ", change.text);
 		break;
-	case WORD_AUX3:
-		msg = txtaux3;
-		// Antenna 1 Gain State
-		switch (bitmask & 0x30) {
-		case 0x00:
-			xLog("#AUX3: Antenna 1 gain in range\n");
-			break;
-		case 0x10:
-			xLog("#AUX3: Antenna 1 gain high\n");
-			break;
-		case 0x20:
-			xLog("#AUX3: Antenna 1 gain low\n");
-			break;
-		case 0x30:
-			xLog("#AUX3: Antenna 1 gain anomaly\n");
-			break;
-		default:
-			xLog("#AUX3: Antenna 1 gain %02X\n", (bitmask & 0x30));
-			break;
-		}
-		// Antenna 2 Gain State
-		switch (bitmask & 0xC0) {
-		case 0x00:
-			xLog("#AUX3: Antenna 2 gain in range\n");
-			break;
-		case 0x40:
-			xLog("#AUX3: Antenna 2 gain high\n");
-			break;
-		case 0x80:
-			xLog("#AUX3: Antenna 2 gain low\n");
-			break;
-		case 0xC0:
-			xLog("#AUX3: Antenna 2 gain anomaly\n");
-			break;
-		default:
-			xLog("#AUX3: Antenna 2 gain %02X\n", (bitmask & 0xC0));
-			break;
-		}
+	}
+#else
+	// No descriptions: bit mask
+	switch (change.severity) {
+	case SEVERITY_ERROR:
+		OEM7_LOG_E("%s ERROR: %s%08X\n", change.name, change.set ? "" : "Cleared: ", change.mask);
 		break;
-	case WORD_AUX4:
-		msg = txtaux4;
+	case SEVERITY_WARNING:
+		OEM7_LOG_W("%s WARNING: %s%08X\n", change.name, change.set ? "" : "Cleared: ", change.mask);
 		break;
 	default:
-		return;
-	}
-	for (uint8_t i = 0; i < sizeof(bitmask) * 8; ++i) {
-		if (bitmask & (1 << i)) {
-			if (strlen(msg[i]) != 0) xLog("%s: %s\n", msg[32], msg[i]);
-		}
+		OEM7_LOG_I("%s: %s%08X\n", change.name, change.set ? "" : "Cleared: ", change.mask);
+		break;
 	}
+#endif
+	BasicReceiver* self = static_cast<BasicReceiver*>(context);
+	if (self->_statusFn != nullptr) self->_statusFn(change, self->_statusContext);
 }
 
-uint32_t oem7::Receiver::crc32(const uint8_t* buffer, size_t size)
+template <typename Port>
+void oem7::BasicReceiver<Port>::hardwareChange(const HealthSensor& sensor, void* context)
 {
-	auto crc32value = [](uint32_t val) {
-	    for (uint8_t i = 8; i > 0; i--) {
-	        if (val & 1)
-	            val = (val >> 1) ^ 0xEDB88320L;
-	        else
-	            val >>= 1;
-	    }
-	    return val;
-	};
-	uint32_t t1, t2;
-	uint32_t crc = 0;
-	while (size-- != 0) {
-	    t1 = (crc >> 8) & 0x00FFFFFFL;
-	    t2 = crc32value((crc ^ *buffer++) & 0xFF);
-	    crc = t1 ^ t2;
-	}
-	return crc;
+	hardwareInfo(sensor.boundary(), sensor.type(), sensor.value());
+#if OEM7_MSG_HWMONITOR
+	BasicReceiver* self = static_cast<BasicReceiver*>(context);
+	if (self->_hardwareFn != nullptr) self->_hardwareFn(sensor, self->_hardwareContext);
+#else
+	(void)context;
+#endif
 }
 
-#ifndef DEBUGLOG
-# ifdef _WIN32
-#  pragma warning(pop)
-# endif
+template class oem7::BasicReceiver<oem7::SerialTransport>;
+template class oem7::BasicReceiver<oem7::MemoryTransport>;
+#if !defined(ESP8266) && !defined(ESP32)
+template class oem7::BasicReceiver<oem7::TcpTransport>;
+template class oem7::BasicReceiver<oem7::UdpTransport>;
+template class oem7::BasicReceiver<oem7::FileTransport>;
 #endif
@@ -7,12 +7,51 @@
 #define __OEM7_RECEIVER_H__
 
 #include "oem7.h"
-#if defined(ESP8266) || defined(ESP32)
-#include "HardwareSerial.h"
-#define SERIALPORT HardwareSerial
-#else
-#include <serialib.h>
-#define SERIALPORT serialib
+#include "Framer.h"
+#include "Dispatcher.h"
+#include "Command.h"
+#include "Diagnostics.h"
+#include "Epoch.h"
+#include "Rovers.h"
+#include "Filter.h"
+#include "Health.h"
+#include "WarmStart.h"
+#include "Capture.h"
+#include "LogProfile.h"
+#include "Registry.h"
+#include "SeqLock.h"
+#include "Stats.h"
+#include "Transport.h"
+
+/// \def OEM7_READER
+/// \brief Background reader support: FreeRTOS task on ESP32, \c std::thread on Win32 and POSIX
+#ifndef OEM7_READER
+# if defined(ESP32) || !(defined(ESP8266) || defined(ARDUINO))
+#  define OEM7_READER 1
+# else
+#  define OEM7_READER 0
+# endif
+#endif
+/// \def OEM7_RECORDS
+/// \brief Capacity of the background reader ring (power of two)
+#ifndef OEM7_RECORDS
+# define OEM7_RECORDS 16
+#endif
+/// \def OEM7_BAUD_MAX
+/// \brief Highest baud rate tried by \c Receiver::negotiate()
+#ifndef OEM7_BAUD_MAX
+# define OEM7_BAUD_MAX 921600
+#endif
+/// \def OEM7_READER_STACK
+/// \brief Stack size of the background reader task on ESP32 (in bytes)
+#ifndef OEM7_READER_STACK
+# define OEM7_READER_STACK 4096
+#endif
+#if OEM7_READER
+#include "Ring.h"
+#if !defined(ESP32)
+#include <thread>
+#endif
 #endif
 
 /// \defgroup oem7rec OEM7 Receiver
@@ -20,31 +59,97 @@
 /// \details A class that provides communication with the GNSS module
 
 namespace oem7 {
-    /// \class oem7::Receiver Receiver.h
-    /// \brief Provide time, position and heading by GNSS with multiple rovers
-    /// \details Send OEM7 commands to GNSS module via serial
-    /// \details Read OEM7 messages from GNSS module via serial
+    /// \struct oem7::Solution Receiver.h
+    /// \brief Latest position and heading
+    /// \details Published atomically by the parsing thread, see \c Receiver::latest()
     /// \ingroup oem7rec
-    class Receiver {
-        Receiver() = delete;
-        Receiver(const Receiver&) = delete;
-        Receiver& operator = (const Receiver&) = delete;
+    struct Solution {
+        uint16_t positionWeek{ 0 };     ///< GPS week of position
+        uint32_t positionMs{ 0 };       ///< GPS milliseconds of week of position
+        uint16_t headingWeek{ 0 };      ///< GPS week of heading
+        uint32_t headingMs{ 0 };        ///< GPS milliseconds of week of heading
+        uint32_t positionReceived{ 0 }; ///< Host monotonic receive time of position (us)
+        uint32_t headingReceived{ 0 };  ///< Host monotonic receive time of heading (us)
+        uint32_t positionType{ 0 };     ///< Bestpos position type (See: \b Position \b or \b Velocity \b Type enumerator)
+        uint32_t headingType{ 0 };      ///< Heading position type (See: \b Position \b or \b Velocity \b Type enumerator)
+        double lat{ 0 };                ///< Latitude (degrees)
+        double lon{ 0 };                ///< Longitude (degrees)
+        double alt{ 0 };                ///< Height above mean sea level (metres)
+        float latDev{ 0 };              ///< Latitude standard deviation (m)
+        float lonDev{ 0 };              ///< Longitude standard deviation (m)
+        float altDev{ 0 };              ///< Height standard deviation (m)
+        float heading{ 0 };             ///< Heading in degrees (0 to 359.999 degrees)
+        float headingDev{ 0 };          ///< Heading standard deviation in degrees
+        float pitch{ 0 };               ///< Pitch (+/-90 degrees)
+        float pitchDev{ 0 };            ///< Pitch standard deviation in degrees
+        float length{ 0 };              ///< Baseline length in metres
+        uint8_t satellitesTracked{ 0 }; ///< Number of satellites tracked
+        uint8_t satellitesUsed{ 0 };    ///< Number of satellites used in solution
+        bool positionValid{ false };    ///< Position solution computed
+        bool headingValid{ false };     ///< Heading solution computed
+        bool healthy{ true };           ///< Last receiver status shows no antenna, RTK or error problems
+        bool valid{ false };            ///< Healthy, position and RTK heading computed for the same epoch
+    };
+
+    /// \class oem7::BasicReceiver Receiver.h
+    /// \brief Provide time, position and heading by GNSS with multiple rovers over any byte transport
+    /// \details Send OEM7 commands to GNSS module via transport (see \ref oem7link)
+    /// \details Read OEM7 messages from GNSS module via transport
+    /// \details All parse state and buffers belong to the instance: separate instances on separate ports
+    /// \details may be updated in parallel from different threads or cores without locking.
+    /// \details One instance must not be used from several threads at the same time.
+    /// \details Instantiated in Receiver.cpp for oem7::SerialTransport and, on Win32 and POSIX, for oem7::TcpTransport,
+    /// \details oem7::UdpTransport and oem7::FileTransport: add an explicit instantiation there for another transport
+    /// \tparam Port Transport
+    /// \ingroup oem7rec
+    template <typename Port>
+    class BasicReceiver {
+        BasicReceiver() = delete;
+        BasicReceiver(const BasicReceiver&) = delete;
+        BasicReceiver& operator = (const BasicReceiver&) = delete;
+    public:
+        /// \brief Size of the embedded frame buffer (in bytes)
+        /// \details \c OEM7_FRAME_SIZE or, with \c OEM7_FRAME_FIT, header and CRC around the longest body of
+        /// \details enabled logs (oem7::ReceiverMessages) and binary command responses
+        static constexpr size_t FRAME_SIZE = OEM7_FRAME_FIT ?
+            HEAD_LENGHT + (ReceiverMessages::largest() > sizeof(uint32_t) + CommandQueue::LINE_SIZE ?
+                ReceiverMessages::largest() : sizeof(uint32_t) + CommandQueue::LINE_SIZE) + sizeof(uint32_t) : OEM7_FRAME_SIZE;
+        static_assert(OEM7_FRAME_SIZE == 0 || FRAME_SIZE >= Framer::MIN_SIZE, "OEM7_FRAME_SIZE is smaller than header and CRC");
     public:
+#if OEM7_FRAME_SIZE > 0
         /// \brief Constructor
-        /// \param serial Serial interface reference
-        explicit Receiver(SERIALPORT& serial);
+        /// \details Uses embedded frame buffer of \c FRAME_SIZE bytes
+        /// \param port Transport reference, must outlive the receiver
+        explicit BasicReceiver(Port& port);
+#endif
+        /// \brief Constructor
+        /// \details Uses caller frame buffer, e.g. larger one for \c RANGE logs or smaller one for small MCUs
+        /// \param port Transport reference, must outlive the receiver
+        /// \param buffer Frame buffer, must outlive the receiver
+        /// \param size Frame buffer size: header, body and CRC (in bytes), at least \c Framer::MIN_SIZE, otherwise no frame is parsed
+        BasicReceiver(Port& port, uint8_t* buffer, const size_t size);
         /// \brief Destructor
-        ~Receiver() {}
+        ~BasicReceiver();
     public:
         /// \brief Starting working GNSS module
         /// \details Call this method at the beginning of the program
-        void begin();
+        /// \details Subscribes to the profile logs only, other logs are not copied into the snapshot
+        /// \details and \c isValid() / \c latest() wait only for the requested solution logs
+        /// \param profile Log subscriptions
+        void begin(const LogProfile& profile = DEFAULT_PROFILE);
         /// \brief Stop working GNSS module
         /// \details Call this method at the end of the program
         void stop();
         /// \brief Update data of GNSS module
-        /// \details To be called in the main program loop
+        /// \details To be called in the main program loop, after \c Receiver::wait()
         void update();
+        /// \brief Wait for GNSS data
+        /// \details Sleeps in the transport until bytes arrive (UART receive event on ESP32, \c poll() after \c watch()
+        /// \details on POSIX, timed read on Win32), so a loop of \c wait() and \c update() does not spin.
+        /// \details Not for use while the background reader runs: the reader waits on the port itself
+        /// \param timeout Wait timeout in ms
+        /// \return \c true if data is available or \c false if timeout
+        inline bool wait(const unsigned long timeout) { return waitAvailable(timeout); }
         /// \brief Factory reset
         /// \details Clears selected data from NVM and reset
         /// \details After reseting restore baud rate
@@ -55,6 +160,188 @@ namespace oem7 {
         /// \details Change default device settings: antenna, status, jammer detection sensitivity etc
         /// \details Call thie method before \c Receiver::begin()
         void config();
+        /// \brief Start with the provisioning cached by the previous start
+        /// \details Skips \c config() and \c begin() when nothing changed, e.g. after an MCU reboot. With a cache of the same
+        /// \details \c provisionHash(), a receiver still logging the profile with the cached build is kept as is: no command
+        /// \details is sent, the first fix is the next epoch (\c START_WARM). A receiver silent for \c OEM7_WARM_WAIT ms
+        /// \details (restarted with the saved configuration) and answering a one-shot \c VERSION request with the cached build
+        /// \details is subscribed by \c begin() only (\c START_SUBSCRIBE). Otherwise
+        /// \details \c config() (if \c configure) and \c begin() are called and the cache is written (\c START_COLD).
+        /// \details Version components are restored from the cache on a warm start. Call with the background reader stopped.
+        /// \details Clear the cache by \c WarmStore::erase() after changing the receiver configuration by other means
+        /// \param profile Log subscriptions
+        /// \param configure Call \c config() on a cold start
+        /// \param key Cache key: NVS key on ESP32, file path on PC
+        /// \return Start kind
+        StartKind warmStart(const LogProfile& profile = DEFAULT_PROFILE, const bool configure = true, const char* key = OEM7_WARM_KEY);
+    public:
+        /// @{
+        /// \name Commands
+        /// \details Commands are queued and pipelined: up to \c OEM7_COMMAND_WINDOW are sent ahead of their replies.
+        /// \details Queue is served by \c Receiver::read() (and so by \c Receiver::update()) and by \c Receiver::waitCommands().
+        /// \details Binary logs received meanwhile are parsed as usual. Use while the background reader is stopped.
+
+        /// \brief Queue abbreviated ASCII command
+        /// \details Never blocks. Example: \code
+        /// gnss.sendCommand("LOG COM1 BESTPOSB ONTIME 0.1", [](const oem7::CommandResult& r, void*) {
+        ///     if (r.status != oem7::CMD_OK) printf("%s: %s\n", r.command, r.reply);
+        /// });
+        /// \endcode
+        /// \param cmd Command without line end, must stay valid until completion (string literal)
+        /// \param fn Completion handler, called with \c OK, error text or timeout
+        /// \param context User context passed to handler
+        /// \param timeout Reply timeout (in ms)
+        /// \return \c false if queue is full
+        bool sendCommand(const char* cmd, CommandHandler fn = nullptr, void* context = nullptr, const unsigned long timeout = OEM7_COMMAND_TIMEOUT);
+        /// \brief Queue binary command
+        /// \details Never blocks. Example: \code
+        /// gnss.sendCommand(oem7::BinaryCommand::log(oem7::PORT_COM1, oem7::MSG_BESTPOS, oem7::TRIGGER_ONTIME, 0.1));
+        /// \endcode
+        /// \param cmd Command, copied
+        /// \param fn Completion handler, called with \c OK, error text or timeout
+        /// \param context User context passed to handler
+        /// \param timeout Reply timeout (in ms)
+        /// \return \c false if queue is full
+        bool sendCommand(const BinaryCommand& cmd, CommandHandler fn = nullptr, void* context = nullptr, const unsigned long timeout = OEM7_COMMAND_TIMEOUT);
+        /// \brief Wait for all queued commands to complete
+        /// \details Frames received meanwhile are passed to handlers and to the snapshot
+        void waitCommands();
+        /// \return Number of queued and in-flight commands
+        inline size_t pendingCommands() const { return _commands.size(); }
+        /// @}
+        /// \brief Find the current baud rate and step up to the fastest clean one
+        /// \details Probes rates with a binary command, switches the receiver port the command came on
+        /// \details (\c THISPORT, so COM1, COM2 or COM3) by \c SERIALCONFIG and confirms a clean binary
+        /// \details response at the new rate, rolling back on failure. Serial is switched by \c Port::setBaud():
+        /// \details \c updateBaudRate() on Arduino (pins are kept), reopened on Win32 and POSIX.
+        /// \details Call before \c Receiver::begin() with the background reader stopped. Not saved: call \c SAVECONFIG to keep
+        /// \param maxBaud Highest baud rate to try
+        /// \return Negotiated baud rate or 0 if receiver does not respond at any rate (or transport is not serial)
+        uint32_t negotiate(const uint32_t maxBaud = OEM7_BAUD_MAX);
+        /// \return Transport
+        inline Port& transport() { return _port; }
+    public:
+        /// @{
+        /// \name Capture and replay
+
+        /// \brief Capture raw received bytes
+        /// \details Every serial read is appended with its host receive time, in the parsing thread
+        /// \details (the background reader if it runs). Flush the writer after capture is removed
+        /// \param writer Capture writer or \c nullptr to stop capture
+        inline void capture(CaptureWriter* writer) { _capture = writer; }
+        /// \brief Pass bytes to the parser as if they were read from serial
+        /// \details Bytes are parsed by the next \c Receiver::read() or \c Receiver::update() before serial data
+        /// \param data Bytes
+        /// \param size Number of bytes
+        /// \param time Host monotonic receive time of the bytes (us), kept in the frames
+        /// \return Number of bytes taken, 0 while previous bytes are not parsed
+        size_t feed(const uint8_t* data, const size_t size, const uint32_t time);
+        /// \brief Replay capture through the parser, handlers and \c Receiver::update()
+        /// \details Frames keep the capture receive times. Use while the background reader is stopped,
+        /// \details serial data received meanwhile is parsed too
+        /// \param reader Capture reader
+        /// \param realtime \c true - original speed, \c false - as fast as possible
+        /// \return Number of replayed records
+        uint32_t replay(CaptureReader& reader, const bool realtime = false);
+        /// @}
+    public:
+        /// @{
+        /// \name Zero-copy access
+
+        /// \brief Read next message without copying
+        /// \details Reads from serial not more than once per call and never blocks
+        /// \details Getters are not updated: pass the frame to \c Receiver::cache() to copy it into the snapshot
+        /// \details Example: \code
+        /// oem7::Frame frame;
+        /// while (gnss.read(frame)) {
+        ///     oem7::MessageView<oem7::BestPos> pos(frame, oem7::MSG_BESTPOS);
+        ///     if (pos) control(pos->lat, pos->lon);
+        /// }
+        /// \endcode
+        /// \param frame Validated frame, points into the receiver buffer and is valid until the next read
+        /// \return \c true if frame is read or \c false if no complete frame is available
+        bool read(Frame& frame);
+        /// \brief Copy message into the cached snapshot used by getters
+        /// \details Checks message size. Logs out of the \c begin() profile are not copied
+        /// \param frame Validated frame
+        /// \return Message ID or 0 if message size is wrong or message is out of the profile
+        uint16_t cache(const Frame& frame);
+        /// @}
+    public:
+        /// @{
+        /// \name Handlers
+        /// \details Handlers are called from \c Receiver::read() and \c Receiver::update() as soon as the frame CRC passes,
+        /// \details before the snapshot is updated. Message data is valid during the call only.
+        /// \details Up to \c OEM7_HANDLERS handlers, each call returns \c false if the table is full
+
+        /// \brief Register handler of any message
+        /// \param msgId Message ID
+        /// \param fn Handler
+        /// \param context User context passed to handler
+        inline bool onMessage(const uint16_t msgId, MessageHandler fn, void* context = nullptr) { return _dispatcher.add(msgId, fn, context); }
+        /// \brief Register handler of \c BESTPOS
+        inline bool onBestPos(Handler<BestPos> fn, void* context = nullptr) { return _dispatcher.add<BestPos>(MSG_BESTPOS, fn, context); }
+        /// \brief Register handler of \c DUALANTENNAHEADING
+        inline bool onHeading(Handler<DualAntHeading> fn, void* context = nullptr) { return _dispatcher.add<DualAntHeading>(MSG_DUALANTHEADING, fn, context); }
+        /// \brief Register handler of \c HEADING2
+        inline bool onHeading2(Handler<Heading2> fn, void* context = nullptr) { return _dispatcher.add<Heading2>(MSG_HEADING2, fn, context); }
+        /// \brief Register handler of \c TIME
+        inline bool onTime(Handler<Time> fn, void* context = nullptr) { return _dispatcher.add<Time>(MSG_TIME, fn, context); }
+        /// \brief Register handler of \c RXSTATUS
+        inline bool onRxStatus(Handler<RxStatus> fn, void* context = nullptr) { return _dispatcher.add<RxStatus>(MSG_RXSTATUS, fn, context); }
+        /// \brief Register handler of \c RXSTATUSEVENT
+        inline bool onRxStatusEvent(Handler<RxStatusEvent> fn, void* context = nullptr) { return _dispatcher.add<RxStatusEvent>(MSG_RXSTATUSEVENT, fn, context); }
+        /// \brief Remove all handlers of message
+        /// \param msgId Message ID
+        inline void removeHandlers(const uint16_t msgId) { _dispatcher.remove(msgId); }
+        /// \brief Set handler of receiver status transitions
+        /// \details Called from \c Receiver::update() for each changed status bit or field, after it is logged
+        /// \param fn Handler or \c nullptr to remove
+        /// \param context User context passed to handler
+        inline void onStatusChange(StatusHandler fn, void* context = nullptr) { _statusFn = fn; _statusContext = context; }
+#if OEM7_MSG_HWMONITOR
+        /// \brief Set handler of hardware boundary limit status transitions
+        /// \details Called from \c Receiver::cache() (and so from \c Receiver::update()) for the first reading of each
+        /// \details \c HWMONITOR type and for each boundary change, after it is logged
+        /// \param fn Handler or \c nullptr to remove
+        /// \param context User context passed to handler
+        inline void onHardwareChange(HealthHandler fn, void* context = nullptr) { _hardwareFn = fn; _hardwareContext = context; }
+#endif
+        /// \brief Set handler of epochs matched by GPS time
+        /// \details Called from \c Receiver::cache() (and so from \c Receiver::update()) for complete, superseded and
+        /// \details incomplete epochs of the requested \c BESTPOS and \c DUALANTENNAHEADING
+        /// \param fn Handler or \c nullptr to remove
+        /// \param context User context passed to handler
+        inline void onEpoch(EpochHandler fn, void* context = nullptr) { _epochs.onEpoch(fn, context); }
+        /// @}
+#if OEM7_READER
+    public:
+        /// @{
+        /// \name Background reader
+        /// \details The reader drains the serial port and parses frames in its own task, decoded messages are
+        /// \details passed to the application through a lock-free single-producer / single-consumer ring.
+        /// \details While the reader runs \c Receiver::update() takes messages from the ring instead of the serial,
+        /// \details so the application consumes either by \c Receiver::update() or by \c Receiver::pop(), not both.
+        /// \details Handlers are called in the reader task.
+        /// \details Send commands (\c begin(), \c config(), \c stop()) only while the reader is stopped.
+
+        /// \brief Start background reader
+        /// \param core CPU core to pin the reader to (-1 - any core)
+        /// \param priority FreeRTOS task priority (ESP32 only)
+        /// \return \c false if already started or task could not be created
+        bool startReader(const int core = -1, const unsigned priority = 1);
+        /// \brief Stop background reader and wait for it to exit
+        void stopReader();
+        /// \return Background reader is running
+        inline bool isReading() const { return _reading.load(std::memory_order_relaxed); }
+        /// \brief Take next message decoded by the background reader
+        /// \param record Message copy
+        /// \return \c false if no message is waiting
+        inline bool pop(Record& record) { return _records.pop(record); }
+        /// \return Number of messages dropped because the ring was full or the message did not fit into oem7::Record
+        inline uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+        /// @}
+#endif
     public:
         /// @{
         /// \name Getters
@@ -65,12 +352,40 @@ namespace oem7 {
         /// \param idx Index of version component
         /// \return Version structure reference
         inline const Version& version(const uint32_t idx) const { return _version[idx > _versionIdx ? 0 : idx]; }
-        /// \return Data valid flag
+        /// \brief Consistent snapshot of position and heading
+        /// \details Lock-free: safe to call from any thread or core while another one parses,
+        /// \details never returns a mix of two updates and never blocks the parser
+        /// \return Latest solution
+        inline Solution latest() const { return _latest.load(); }
+        /// \brief Parser counters and timing histograms
+        /// \details Lock-free: safe to call from any thread or core. Parser counters are one consistent copy,
+        /// \details published by the parsing thread once per drained batch; \c update() timing is published by \c update()
+        /// \return Statistics
+        ReceiverStats stats() const;
+        /// \brief Filtered position and heading predicted to the current time
+        /// \details Continuous between solutions, e.g. for a control loop faster than the log rate (see oem7::SolutionFilter)
+        /// \return Estimate
+        Estimate estimate() const;
+        /// \return Data valid flag: position and heading getters are of one complete epoch
         inline bool isValid() const { return _valid; }
+        /// \return Epoch matcher: complete, superseded and incomplete epochs
+        inline const EpochMatcher& epochs() const { return _epochs; }
         /// \return Jamming detected
         inline bool isJamming() const { return (_rxstatus.rxstat & 0x00008000); }
         /// \return Spoofing detected
         inline bool isSpoofing() const { return _rxstatus.rxstat & 0x00000200; }
+        /// \return The highest severity of the current receiver status
+        inline Severity severity() const { return _diagnostics.severity(); }
+#if OEM7_MSG_HWMONITOR
+        /// \brief Hardware readings by type: latest, recent, extremes, mean and boundary transitions
+        /// \details Updated by \c HWMONITOR logs, read from the thread calling \c update()
+        /// \return Hardware health table
+        inline const HardwareHealth& hardware() const { return _hardware; }
+#endif
+        /// \return Receiver software build number of the latest long header (0 - none received)
+        inline uint16_t receiverVersion() const { return _receiverVersion; }
+        /// \return Receiver CPU idle time of the latest message (%)
+        inline float idleTime() const { return _idleTime * 0.5f; }
         /// \return Bestpos position type (See: \b Position \b or \b Velocity \b Type enumerator)
         inline uint8_t positionType() const { return _bestpos.positionType; }
         /// \return Heading position type (See: \b Position \b or \b Velocity \b Type enumerator)
@@ -95,6 +410,8 @@ namespace oem7 {
         inline double pitch() const { return _heading.pitch; }
         /// \return Pitch standard deviation in degrees
         inline float pitchDev() const { return _heading.ptchStdDev; }
+        /// \return \c HEADING2 solutions by rover, subscribe to \c HEADING2 in the \c begin() profile
+        inline const RoverTable& rovers() const { return _rovers; }
         /// \return Number of Satellites in View
         inline uint8_t satellitesView() const { return _heading.satellitesTracked; }
         /// \return Number of Satellites in Used
@@ -120,19 +437,77 @@ namespace oem7 {
         /// @}
     private:
         /// \brief Send command to GNSS module
-        /// \details Using abbreviated ASCII command
+        /// \details Using abbreviated ASCII command. Queued with logging of the reply, waits only if queue is full
         /// \details See: https://docs.novatel.com/OEM7/Content/Commands/OEM7_Core_Commands.htm
         /// \param cmd Abbreviated ASCII command
         void setCommand(const char* cmd);
+        /// \brief Send binary command to GNSS module
+        /// \details Queued with logging of the response, waits only if queue is full
+        /// \param cmd Binary command
+        void setCommand(const BinaryCommand& cmd);
+        /// \brief Switch serial baud rate and drop bytes received at the old rate
+        /// \param baud Baud rate
+        /// \return \c false if serial could not be switched
+        bool setBaud(const uint32_t baud);
+        /// \brief Check binary link at the current baud rate
+        /// \return \c true if a binary command got a clean response
+        bool probe();
+        /// \brief Switch receiver and serial from one baud rate to another
+        /// \details Rolls back to \c from on failure
+        /// \return \c true if link is clean at \c to
+        bool stepBaud(const uint32_t from, const uint32_t to);
+        /// \brief Store command status into \c CommandStatus context
+        static void storeStatus(const CommandResult& result, void* context);
+        /// \brief Body of \c update(): take decoded messages and validate the solution
+        void process();
+        /// \brief Count event of message
+        /// \param msgId Message ID
+        /// \param counter Counter of oem7::MessageStats
+        /// \param allocate A new ID takes a free slot, otherwise it is counted by \c ReceiverStats::other
+        void count(const uint16_t msgId, uint32_t MessageStats::* counter, const bool allocate = true);
+        /// \brief Publish parser counters if they changed
+        void publishStats();
+        /// \brief Count latency and receiver idle time of log
+        /// \param frame Validated log frame
+        void measure(const Frame& frame);
+        /// \brief Send commands allowed by the window and complete timed out ones
+        void service();
+        /// \brief Parse one frame into the snapshot or wait a bit for data
+        void pump();
+        /// \brief Text outside binary frames: command replies
+        static void onText(const uint8_t* data, size_t size, void* context);
+        /// \brief Log command completion
+        static void logCommand(const CommandResult& result, void* context);
         /// \brief Read GNSS data
-        /// \details Read and parse data from serial
-        /// \details Check data CRC
+        /// \details Read all complete messages and copy them into the snapshot
+        /// \details Never blocks: partial frames are kept until the next call
         /// \details See: https://docs.novatel.com/OEM7/Content/Messages/Binary.htm
-        uint16_t getData();
+        /// \return Bitmask of decoded messages (\c GET_* flags)
+        uint32_t getData();
         /// \brief Wait for serial available
+        /// \details Fed bytes first, then sleeps in \c Port::wait() until data arrives
         /// \param timeout Wait timeout in ms
         /// \return \c true if serial available or \c false if timeout
-        bool waitAvailable(const unsigned long timeout) const;
+        bool waitAvailable(const unsigned long timeout);
+        /// \brief Receiver state of the profile logs: snapshot filter, solution filter and epoch matcher
+        /// \param profile Log subscriptions
+        void track(const LogProfile& profile);
+        /// \brief Write provisioning of the connected receiver into the cache
+        /// \param key Cache key
+        /// \param hash Provisioning hash
+        void saveWarm(const char* key, const uint32_t hash);
+        /// \param msgId Message ID
+        /// \return \c GET_* flag of message
+        static constexpr uint32_t flag(const uint16_t msgId) { return Messages::flag(msgId); }
+#if OEM7_READER
+        /// \brief Background reader loop
+        void reader();
+#if defined(ESP32)
+        /// \brief Background reader FreeRTOS task
+        /// \param arg oem7::BasicReceiver pointer
+        static void readerTask(void* arg);
+#endif
+#endif
     private:
         /// \brief Print hardware monitor parameters
         /// \details Print hardware monitor temperature, antenna current and voltages
@@ -140,29 +515,192 @@ namespace oem7 {
         /// \param type Reading type of oem7::HWMonitor structure
         /// \param value Temperature, antenna current or voltage reading of oem7::HWMonitor structure
         static void hardwareInfo(const uint8_t boundary, const uint8_t type, const float value);
-        /// \brief Print status info
-        /// \details Print information about receiver and auxiliary bitmask
-        /// \param word Status word of oem7::RxStatus structure
-        /// \param bitmask receiver error, receiver status or auxiliary status of oem7::RxStatus structure
-        static void statusInfo(const uint8_t word, const uint32_t bitmask);
-	    /// \brief Calculates the CRC-32 of a block of data all at once
-	    /// \param buffer Data block buffer
-	    /// \param size Data block size (in bytes)
-	    /// \return CRC for data verification
-        static uint32_t crc32(const uint8_t* buffer, size_t size);
+        /// \brief Print status transition and pass it to the user handler
+        /// \param change Status transition
+        /// \param context oem7::BasicReceiver pointer
+        static void statusChange(const StatusChange& change, void* context);
+        /// \brief Print hardware boundary transition and pass it to the user handler
+        /// \param sensor Readings of the changed type
+        /// \param context oem7::BasicReceiver pointer
+        static void hardwareChange(const HealthSensor& sensor, void* context);
+        /// \brief Check antennas and RTK status
+        /// \param status Receiver status
+        /// \return \c false if antenna, LNA, gain, position or clock problem is reported
+        static bool isHealthy(const RxStatus& status);
+        /// \brief Apply status event to receiver status
+        /// \details Sets or clears the event bit in the status word of the event
+        /// \param status Receiver status
+        /// \param event Status event
+        static void applyEvent(RxStatus& status, const RxStatusEvent& event);
+        /// \param positionType Heading position type
+        /// \return Heading is RTK solution (integer or float)
+        static bool isRtk(const uint32_t positionType);
+        /// \brief Publish solution message into the latest solution snapshot
+        /// \param frame Validated frame
+        void publish(const Frame& frame);
+        /// \brief Copy message into the snapshot
+        /// \details Called by \c Receiver::cache() once the body size is checked against oem7::MessageTraits.
+        /// \details Registered messages without an overload are framed and dispatched but not copied
+        /// \param frame Validated frame
+        template <typename T>
+        inline void store(MessageTag<T>, const Frame& frame) { (void)frame; }
+#if OEM7_MSG_VERSION
+        void store(MessageTag<Version>, const Frame& frame);
+#endif
+#if OEM7_MSG_HWMONITOR
+        void store(MessageTag<HWMonitor>, const Frame& frame);
+#endif
+        void store(MessageTag<RxStatus>, const Frame& frame);
+        void store(MessageTag<RxStatusEvent>, const Frame& frame);
+        void store(MessageTag<Time>, const Frame& frame);
+        void store(MessageTag<BestPos>, const Frame& frame);
+        void store(MessageTag<DualAntHeading>, const Frame& frame);
+#if OEM7_MSG_HEADING2
+        void store(MessageTag<Heading2>, const Frame& frame);
+#endif
     private:
-        SERIALPORT& _serial;
+        /// \brief Decoded messages
+        typedef ReceiverMessages Messages;
+        /// \brief Get Data Flag: bit of message in oem7::ReceiverMessages, 0 if compiled out
+        static constexpr uint32_t GET_HWMONITOR = Messages::flag<HWMonitor>();
+        static constexpr uint32_t GET_RXSTATUS = Messages::flag<RxStatus>();
+        static constexpr uint32_t GET_TIME = Messages::flag<Time>();
+        static constexpr uint32_t GET_BESTPOS = Messages::flag<BestPos>();
+        static constexpr uint32_t GET_HEADING = Messages::flag<DualAntHeading>();
+        static constexpr uint32_t GET_VERSION = Messages::flag<Version>();
+        static constexpr uint32_t GET_RXEVENT = Messages::flag<RxStatusEvent>();
+        static constexpr uint32_t GET_HEADING2 = Messages::flag<Heading2>();
+        /// \brief Receive buffer size
+        enum { RX_SIZE = 256 };
+        Port& _port;
+        uint32_t _subscribed{ GET_HWMONITOR | GET_RXSTATUS | GET_TIME | GET_BESTPOS | GET_HEADING };
+#if OEM7_FRAME_SIZE > 0
+        uint8_t _storage[FRAME_SIZE];
+#endif
+        Framer _framer;
+        Dispatcher _dispatcher;
+        CommandQueue _commands;
+        Solution _solution;
+        RxStatus _health{ 0 };
+        SeqLock<Solution> _latest;
+        ReceiverStats _stats;
+        SeqLock<ReceiverStats> _statsLock;
+        bool _statsDirty{ false };
+        Histogram _updateTime;
+        SeqLock<Histogram> _updateLock;
+        EpochClock _clock;
+        CaptureWriter* _capture{ nullptr };
+        uint32_t _rxTime{ 0 };
+        size_t _rxPos{ 0 };
+        size_t _rxLen{ 0 };
+        uint8_t _rx[RX_SIZE]{};
+#if OEM7_READER
+        std::atomic_bool _reading{ false };
+        std::atomic<uint32_t> _dropped{ 0 };
+        Ring<Record, OEM7_RECORDS> _records;
+#if defined(ESP32)
+        std::atomic_bool _readerDone{ true };
+#else
+        std::thread _thread;
+#endif
+#endif
         bool _valid{ false };
         uint32_t _versionIdx{ 0 };
         uint32_t _measurement{ 0 };
-        Version _version[8]{ 0 };
-        HWMonitor _monitor[10]{ 0 };
+        uint8_t _idleTime{ 0 };
+        uint16_t _receiverVersion{ 0 };
+        MessageSlot<Version, MessageTraits<Version>::capacity> _version;
+        MessageSlot<HWMonitor, MessageTraits<HWMonitor>::capacity> _monitor;
 	    RxStatus _rxstatus{ 0 };
         RxStatusEvent _event{ 0 };
+        Diagnostics _diagnostics;
+        EpochMatcher _epochs;
+        SolutionFilter _filter;
+        StatusHandler _statusFn{ nullptr };
+        void* _statusContext{ nullptr };
+#if OEM7_MSG_HWMONITOR
+        HardwareHealth _hardware;
+        HealthHandler _hardwareFn{ nullptr };
+        void* _hardwareContext{ nullptr };
+#endif
 	    Time _time{ 0 };
 	    BestPos _bestpos{ 0 };
 	    DualAntHeading _heading{ 0 };
+        RoverTable _rovers;
+    };
+
+    /// \struct oem7::SerialLink Receiver.h
+    /// \brief Serial transport of oem7::Receiver, constructed before the receiver base
+    /// \ingroup oem7rec
+    struct SerialLink {
+        /// \brief Constructor
+        /// \param serial Serial interface reference
+        explicit SerialLink(SERIALPORT& serial) : link(serial) {}
+        SerialTransport link;   ///< Serial transport
+    };
+
+    /// \class oem7::Receiver Receiver.h
+    /// \brief Receiver on a serial port
+    /// \details oem7::BasicReceiver of its own oem7::SerialTransport
+    /// \ingroup oem7rec
+    class Receiver : private SerialLink, public BasicReceiver<SerialTransport> {
+    public:
+#if OEM7_FRAME_SIZE > 0
+        /// \brief Constructor
+        /// \details Uses embedded frame buffer of \c FRAME_SIZE bytes
+        /// \param serial Serial interface reference
+        explicit Receiver(SERIALPORT& serial) : SerialLink(serial), BasicReceiver<SerialTransport>(link) {}
+#endif
+        /// \brief Constructor
+        /// \details Uses caller frame buffer, e.g. larger one for \c RANGE logs or smaller one for small MCUs
+        /// \param serial Serial interface reference
+        /// \param buffer Frame buffer, must outlive the receiver
+        /// \param size Frame buffer size: header, body and CRC (in bytes), at least \c Framer::MIN_SIZE
+        Receiver(SERIALPORT& serial, uint8_t* buffer, const size_t size) : SerialLink(serial), BasicReceiver<SerialTransport>(link, buffer, size) {}
+    public:
+#if !defined(ESP8266) && !defined(ESP32)
+        using BasicReceiver<SerialTransport>::negotiate;
+        /// \brief Find the current baud rate and step up to the fastest clean one
+        /// \details Serial is reopened at each rate, see \c BasicReceiver::negotiate()
+        /// \param device Device name passed to \c serialib::openDevice(), must stay valid
+        /// \param maxBaud Highest baud rate to try
+        /// \return Negotiated baud rate or 0 if receiver does not respond at any rate
+        inline uint32_t negotiate(const char* device, const uint32_t maxBaud = OEM7_BAUD_MAX)
+        {
+            link.device(device);
+            return BasicReceiver<SerialTransport>::negotiate(maxBaud);
+        }
+#endif
+#if !defined(ESP8266) && !defined(ESP32) && !defined(_WIN32)
+        /// \brief Wait for serial data with \c poll(), see \c SerialTransport::watch()
+        /// \param device Device name passed to \c serialib::openDevice(), e.g. "/dev/ttyUSB0"
+        /// \return \c false if device could not be opened
+        inline bool watch(const char* device) { return link.watch(device); }
+#endif
     };
+
+    /// \brief Compile-time RAM report of oem7::Receiver
+    /// \details With \c OEM7_RAM_REPORT declared, each unit including Receiver.h warns that this function is
+    /// \details deprecated, and the warning names the sizes (in bytes). With \c OEM7_RAM_LIMIT the build fails above the limit
+    /// \tparam Total oem7::Receiver
+    /// \tparam FrameBuffer Embedded frame buffer, see \c BasicReceiver::FRAME_SIZE
+    /// \tparam Commands Command queue
+    /// \tparam Reader Background reader ring
+    /// \ingroup oem7rec
+    template <size_t Total, size_t FrameBuffer, size_t Commands, size_t Reader>
+    [[deprecated("RAM footprint of oem7::Receiver, see OEM7_RAM_REPORT")]] constexpr bool ramFootprint() { return true; }
 }
 
+#ifdef OEM7_RAM_REPORT
+static_assert(oem7::ramFootprint<sizeof(oem7::Receiver), (OEM7_FRAME_SIZE > 0 ? oem7::Receiver::FRAME_SIZE : 0), sizeof(oem7::CommandQueue),
+#if OEM7_READER
+    sizeof(oem7::Ring<oem7::Record, OEM7_RECORDS>)>(), "RAM report");
+#else
+    0>(), "RAM report");
+#endif
+#endif
+#ifdef OEM7_RAM_LIMIT
+static_assert(sizeof(oem7::Receiver) <= OEM7_RAM_LIMIT, "oem7::Receiver is larger than OEM7_RAM_LIMIT");
+#endif
+
 #endif // __OEM7_RECEIVER_H__
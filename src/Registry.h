@@ -0,0 +1,285 @@
+/// \file       Registry.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_REGISTRY_H__
+#define __OEM7_REGISTRY_H__
+
+#include "oem7.h"
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+/// \def OEM7_MSG_VERSION
+/// \brief Decode \c VERSION into the snapshot (1) or compile it out (0)
+/// \details The same for each \c OEM7_MSG_* macro. Logs compiled out are still framed, checked and passed to handlers,
+/// \details but are not copied, so their getters keep defaults. Declare in build flags to override
+#ifndef OEM7_MSG_VERSION
+# define OEM7_MSG_VERSION 1
+#endif
+/// \def OEM7_MSG_HWMONITOR
+/// \brief Decode \c HWMONITOR
+#ifndef OEM7_MSG_HWMONITOR
+# define OEM7_MSG_HWMONITOR 1
+#endif
+/// \def OEM7_MSG_RXSTATUS
+/// \brief Decode \c RXSTATUS
+#ifndef OEM7_MSG_RXSTATUS
+# define OEM7_MSG_RXSTATUS 1
+#endif
+/// \def OEM7_MSG_RXSTATUSEVENT
+/// \brief Decode \c RXSTATUSEVENT
+#ifndef OEM7_MSG_RXSTATUSEVENT
+# define OEM7_MSG_RXSTATUSEVENT 1
+#endif
+/// \def OEM7_MSG_TIME
+/// \brief Decode \c TIME
+#ifndef OEM7_MSG_TIME
+# define OEM7_MSG_TIME 1
+#endif
+/// \def OEM7_MSG_BESTPOS
+/// \brief Decode \c BESTPOS
+#ifndef OEM7_MSG_BESTPOS
+# define OEM7_MSG_BESTPOS 1
+#endif
+/// \def OEM7_MSG_DUALANTHEADING
+/// \brief Decode \c DUALANTENNAHEADING
+#ifndef OEM7_MSG_DUALANTHEADING
+# define OEM7_MSG_DUALANTHEADING 1
+#endif
+/// \def OEM7_MSG_HEADING2
+/// \brief Decode \c HEADING2
+#ifndef OEM7_MSG_HEADING2
+# define OEM7_MSG_HEADING2 1
+#endif
+/// \def OEM7_MSG_INSATTS
+/// \brief Check \c INSATTS (short header): no snapshot, read it by handlers or oem7::MessageView
+#ifndef OEM7_MSG_INSATTS
+# define OEM7_MSG_INSATTS 1
+#endif
+
+namespace oem7 {
+    /// \struct oem7::MessageType Registry.h
+    /// \brief Base of oem7::MessageTraits
+    /// \tparam Id Message ID
+    /// \tparam Enabled Message is decoded
+    /// \tparam Capacity 0 - fixed size body, otherwise the most elements of a count-prefixed body
+    /// \ingroup oem7rec
+    template <uint16_t Id, bool Enabled, uint8_t Capacity = 0>
+    struct MessageType {
+        static constexpr uint16_t id = Id;              ///< Message ID
+        static constexpr bool enabled = Enabled;        ///< Message is decoded
+        static constexpr uint8_t capacity = Capacity;   ///< Capacity of a count-prefixed body, 0 - fixed size
+    };
+    /// \struct oem7::MessageTraits Registry.h
+    /// \brief Message ID, name and body layout of message structure
+    /// \details Specialize for a new log, e.g. \code
+    /// template <> struct MessageTraits<BestVel> : MessageType<MSG_BESTVEL, true> { static constexpr const char* name = "BESTVEL"; };
+    /// \endcode
+    /// \tparam T Message structure: a fixed size body or, with \c Capacity, an element after \c uint32_t count
+    /// \ingroup oem7rec
+    template <typename T>
+    struct MessageTraits;
+    template <> struct MessageTraits<Version> : MessageType<MSG_VERSION, OEM7_MSG_VERSION != 0, 8> { static constexpr const char* name = "VERSION"; };
+    template <> struct MessageTraits<HWMonitor> : MessageType<MSG_HWMONITOR, OEM7_MSG_HWMONITOR != 0, 10> { static constexpr const char* name = "HWMONITOR"; };
+    template <> struct MessageTraits<RxStatus> : MessageType<MSG_RXSTATUS, OEM7_MSG_RXSTATUS != 0> { static constexpr const char* name = "RXSTATUS"; };
+    template <> struct MessageTraits<RxStatusEvent> : MessageType<MSG_RXSTATUSEVENT, OEM7_MSG_RXSTATUSEVENT != 0> { static constexpr const char* name = "RXSTATUSEVENT"; };
+    template <> struct MessageTraits<Time> : MessageType<MSG_TIME, OEM7_MSG_TIME != 0> { static constexpr const char* name = "TIME"; };
+    template <> struct MessageTraits<BestPos> : MessageType<MSG_BESTPOS, OEM7_MSG_BESTPOS != 0> { static constexpr const char* name = "BESTPOS"; };
+    template <> struct MessageTraits<DualAntHeading> : MessageType<MSG_DUALANTHEADING, OEM7_MSG_DUALANTHEADING != 0> { static constexpr const char* name = "DUALANTENNAHEADING"; };
+    template <> struct MessageTraits<Heading2> : MessageType<MSG_HEADING2, OEM7_MSG_HEADING2 != 0> { static constexpr const char* name = "HEADING2"; };
+    template <> struct MessageTraits<InsAttS> : MessageType<MSG_INSATTS, OEM7_MSG_INSATTS != 0> { static constexpr const char* name = "INSATTS"; };
+
+    /// \struct oem7::MessageTag Registry.h
+    /// \brief Empty value selecting the overload of message structure
+    /// \ingroup oem7rec
+    template <typename T>
+    struct MessageTag {
+        typedef T Type;     ///< Message structure
+    };
+
+    /// \class oem7::MessageSlot Registry.h
+    /// \brief Snapshot storage of message structure
+    /// \details Empty if the message is compiled out: elements read as zero and cannot be written
+    /// \tparam T Message structure
+    /// \tparam N Number of elements
+    /// \tparam Enabled Message is decoded
+    /// \ingroup oem7rec
+    template <typename T, size_t N = 1, bool Enabled = MessageTraits<T>::enabled>
+    class MessageSlot {
+    public:
+        /// \param idx Element index (less than \c N)
+        /// \return Element
+        inline T& operator [] (const size_t idx) { return _items[idx]; }
+        /// \param idx Element index (less than \c N)
+        /// \return Element
+        inline const T& operator [] (const size_t idx) const { return _items[idx]; }
+    private:
+        T _items[N]{};
+    };
+    template <typename T, size_t N>
+    class MessageSlot<T, N, false> {
+    public:
+        inline const T& operator [] (const size_t idx) const { (void)idx; return _empty; }
+    private:
+        static constexpr T _empty{};
+    };
+
+    /// \struct oem7::MessageInfo Registry.h
+    /// \brief Registered message
+    /// \ingroup oem7rec
+    struct MessageInfo {
+        uint16_t msgId{ 0 };            ///< Message ID
+        uint16_t size{ 0 };             ///< Body size or element size of a count-prefixed body (in bytes)
+        uint8_t capacity{ 0 };          ///< The most elements of a count-prefixed body, 0 - fixed size
+        uint8_t index{ 0 };             ///< Position in oem7::MessageList
+        uint32_t flag{ 0 };             ///< Bit of message in masks of oem7::MessageList
+        const char* name{ nullptr };    ///< Log name
+        /// \brief Check body size
+        /// \param body Message body
+        /// \param length Body size (in bytes)
+        /// \return Size is of the structure, or of the count and the elements it declares
+        inline bool accepts(const uint8_t* body, const size_t length) const
+        {
+            if (capacity == 0) return length == size;
+            if (length < sizeof(uint32_t)) return false;
+            uint32_t count = 0;
+            memcpy(&count, body, sizeof(count));
+            return count <= capacity && length - sizeof(uint32_t) == count * size;
+        }
+    };
+
+    /// \class oem7::MessageList Registry.h
+    /// \brief Compile-time registry of decoded messages
+    /// \details Built from oem7::MessageTraits of each structure: a table sorted by message ID for binary search,
+    /// \details one mask bit per message (\c flag()) and dispatch to the overload of the message tag.
+    /// \details Messages that are not enabled are left out of the table and their overloads are not instantiated
+    /// \tparam T Message structures, up to 32
+    /// \ingroup oem7rec
+    template <typename... T>
+    class MessageList {
+        static_assert(sizeof...(T) > 0 && sizeof...(T) <= 32, "Message list holds 1 to 32 messages");
+    public:
+        /// \brief Number of messages (enabled or not)
+        static constexpr size_t COUNT = sizeof...(T);
+        /// \tparam M Message structure
+        /// \return Mask bit of message, 0 if it is not in the list or not enabled
+        template <typename M>
+        static constexpr uint32_t flag()
+        {
+            return position<M>() < COUNT && MessageTraits<M>::enabled ? static_cast<uint32_t>(1) << position<M>() : 0;
+        }
+        /// \param msgId Message ID
+        /// \return Mask bit of message, 0 if it is not registered
+        static constexpr uint32_t flag(const uint16_t msgId)
+        {
+            const MessageInfo* info = find(msgId);
+            return info != nullptr ? info->flag : 0;
+        }
+        /// \return The longest body of enabled messages (in bytes)
+        static constexpr size_t largest()
+        {
+            size_t result = 0;
+            for (size_t i = 0; i < _table.count; ++i) {
+                const MessageInfo& info = _table.items[i];
+                const size_t size = info.capacity == 0 ? info.size : sizeof(uint32_t) + info.capacity * static_cast<size_t>(info.size);
+                if (size > result) result = size;
+            }
+            return result;
+        }
+        /// \param msgId Message ID
+        /// \return Registered message or \c nullptr
+        static constexpr const MessageInfo* find(const uint16_t msgId)
+        {
+            size_t low = 0;
+            size_t high = _table.count;
+            while (low < high) {
+                const size_t mid = (low + high) / 2;
+                if (_table.items[mid].msgId < msgId) low = mid + 1;
+                else high = mid;
+            }
+            return low < _table.count && _table.items[low].msgId == msgId ? &_table.items[low] : nullptr;
+        }
+        /// \brief Call \c fn(oem7::MessageTag<M>()) for structure \c M of registered message
+        /// \param info Registered message returned by \c find()
+        /// \param fn Generic callable
+        template <typename F>
+        static void dispatch(const MessageInfo& info, F& fn)
+        {
+            typedef void (*Call)(F&);
+            static constexpr Call calls[] = { &call<F, T>... };
+            calls[info.index](fn);
+        }
+    private:
+        /// \brief Message table
+        struct Table {
+            MessageInfo items[COUNT];
+            size_t count{ 0 };
+        };
+        /// \return Position of structure in the list, \c COUNT if it is not there
+        template <typename M>
+        static constexpr size_t position()
+        {
+            constexpr bool same[] = { std::is_same<M, T>::value... };
+            for (size_t i = 0; i < COUNT; ++i) {
+                if (same[i]) return i;
+            }
+            return COUNT;
+        }
+        /// \return Registered message of structure
+        template <typename M>
+        static constexpr MessageInfo info()
+        {
+            MessageInfo result;
+            result.msgId = MessageTraits<M>::id;
+            result.size = static_cast<uint16_t>(sizeof(M));
+            result.capacity = MessageTraits<M>::capacity;
+            result.index = static_cast<uint8_t>(position<M>());
+            result.flag = flag<M>();
+            result.name = MessageTraits<M>::name;
+            return result;
+        }
+        /// \return Enabled messages sorted by message ID
+        static constexpr Table sorted()
+        {
+            const MessageInfo all[] = { info<T>()... };
+            const bool enabled[] = { MessageTraits<T>::enabled... };
+            Table table{};
+            for (size_t i = 0; i < COUNT; ++i) {
+                if (!enabled[i]) continue;
+                // Insertion sort: a few messages, at compile time
+                size_t j = table.count++;
+                while (j > 0 && table.items[j - 1].msgId > all[i].msgId) {
+                    table.items[j] = table.items[j - 1];
+                    --j;
+                }
+                table.items[j] = all[i];
+            }
+            return table;
+        }
+        /// \return Every registered message ID is unique
+        static constexpr bool unique()
+        {
+            for (size_t i = 1; i < _table.count; ++i) {
+                if (_table.items[i - 1].msgId == _table.items[i].msgId) return false;
+            }
+            return true;
+        }
+        template <typename F, typename M>
+        static void call(F& fn)
+        {
+            if constexpr (MessageTraits<M>::enabled) fn(MessageTag<M>());
+        }
+    private:
+        static constexpr Table _table = sorted();
+        static_assert(unique(), "Message ID is registered twice");
+    };
+
+    /// \brief Messages decoded by oem7::BasicReceiver
+    /// \details Order sets the mask bits of \c Receiver::update(): append new logs at the end
+    /// \ingroup oem7rec
+    typedef MessageList<HWMonitor, RxStatus, Time, BestPos, DualAntHeading, Version, RxStatusEvent, Heading2, InsAttS> ReceiverMessages;
+}
+
+#endif // __OEM7_REGISTRY_H__
@@ -0,0 +1,61 @@
+/// \file       Ring.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_RING_H__
+#define __OEM7_RING_H__
+
+#include <stddef.h>
+#include <atomic>
+
+namespace oem7 {
+    /// \class oem7::Ring Ring.h
+    /// \brief Lock-free single-producer / single-consumer ring buffer
+    /// \details One thread (or core) pushes, one other thread pops. No locks, no heap allocation
+    /// \tparam T Trivially copyable element
+    /// \tparam N Capacity, power of two
+    /// \ingroup oem7rec
+    template <typename T, size_t N>
+    class Ring {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "Ring capacity must be a power of two");
+        Ring(const Ring&) = delete;
+        Ring& operator = (const Ring&) = delete;
+    public:
+        /// \brief Constructor
+        Ring() {}
+    public:
+        /// \brief Push element (producer side)
+        /// \param item Element
+        /// \return \c false if ring is full
+        bool push(const T& item)
+        {
+            const size_t head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) >= N) return false;
+            _data[head & (N - 1)] = item;
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+        /// \brief Pop element (consumer side)
+        /// \param item Element
+        /// \return \c false if ring is empty
+        bool pop(T& item)
+        {
+            const size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire)) return false;
+            item = _data[tail & (N - 1)];
+            _tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+        /// \return Number of elements
+        inline size_t size() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+        /// \return Capacity
+        static constexpr size_t capacity() { return N; }
+    private:
+        std::atomic<size_t> _head{ 0 };
+        std::atomic<size_t> _tail{ 0 };
+        T _data[N];
+    };
+}
+
+#endif // __OEM7_RING_H__
@@ -0,0 +1,54 @@
+/// \file       Rovers.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "Rovers.h"
+#include <string.h>
+
+const oem7::Rover* oem7::RoverTable::update(const Head& head, const Heading2& heading, const uint32_t received)
+{
+	const uint32_t id = key(heading.roverID);
+	size_t i = index(id);
+	if (i == _count) {
+		if (_count >= OEM7_ROVERS) {
+			++_overflow;
+			return nullptr;
+		}
+		_keys[i] = id;
+		_rovers[i] = Rover();
+		memcpy(&_rovers[i].id[0], &id, sizeof(id));
+		++_count;
+	}
+	Rover& rover = _rovers[i];
+	rover.heading = heading;
+	rover.week = head.week;
+	rover.ms = head.ms;
+	rover.received = received;
+	++rover.updates;
+	return &rover;
+}
+
+const oem7::Rover* oem7::RoverTable::find(const char* id) const
+{
+	const size_t i = index(key(id));
+	return i < _count ? &_rovers[i] : nullptr;
+}
+
+size_t oem7::RoverTable::index(const uint32_t key) const
+{
+	for (size_t i = 0; i < _count; ++i) {
+		if (_keys[i] == key) return i;
+	}
+	return _count;
+}
+
+uint32_t oem7::RoverTable::key(const char* id)
+{
+	// ID is up to 4 characters, not always terminated
+	char text[4] = { 0, 0, 0, 0 };
+	for (size_t i = 0; i < sizeof(text) && id[i] != '\0'; ++i) text[i] = id[i];
+	uint32_t result = 0;
+	memcpy(&result, &text[0], sizeof(result));
+	return result;
+}
@@ -0,0 +1,89 @@
+/// \file       Rovers.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_ROVERS_H__
+#define __OEM7_ROVERS_H__
+
+#include "oem7.h"
+#include <stddef.h>
+
+/// \def OEM7_ROVERS
+/// \brief Capacity of the \c HEADING2 rover table
+/// \details Declare in build flags to override
+#ifndef OEM7_ROVERS
+# define OEM7_ROVERS 4
+#endif
+
+namespace oem7 {
+    /// \struct oem7::Rover Rovers.h
+    /// \brief Latest \c HEADING2 solution of one rover
+    /// \ingroup oem7rec
+    struct Rover {
+        char id[5]{};               ///< Rover receiver ID, terminated
+        Heading2 heading{};         ///< Latest solution
+        uint16_t week{ 0 };         ///< GPS reference week of solution
+        uint32_t ms{ 0 };           ///< Milliseconds of the GPS reference week of solution
+        uint32_t received{ 0 };     ///< Host monotonic receive time of solution (us)
+        uint32_t updates{ 0 };      ///< Number of solutions received
+        /// \param now Host monotonic time (us), e.g. \c micros()
+        /// \return Age of solution (us)
+        inline uint32_t age(const uint32_t now) const { return now - received; }
+    };
+
+    /// \class oem7::RoverTable Rovers.h
+    /// \brief Fixed-capacity table of \c HEADING2 baselines keyed by rover ID
+    /// \details Rover IDs are kept apart from the solutions as 32-bit keys, so a lookup scans one cache line.
+    /// \details Rovers are kept in order of the first solution, no heap allocation. Example: \code
+    /// for (const oem7::Rover& rover : gnss.rovers()) {
+    ///     printf("%s: %.2f\n", rover.id, rover.heading.heading);
+    /// }
+    /// \endcode
+    /// \ingroup oem7rec
+    class RoverTable {
+        RoverTable(const RoverTable&) = delete;
+        RoverTable& operator = (const RoverTable&) = delete;
+    public:
+        /// \brief Constructor
+        RoverTable() {}
+    public:
+        /// \brief Store solution
+        /// \param head Message header
+        /// \param heading Solution
+        /// \param received Host monotonic receive time (us)
+        /// \return Rover or \c nullptr if table is full
+        const Rover* update(const Head& head, const Heading2& heading, const uint32_t received);
+        /// \param id Rover receiver ID, 4 characters as in oem7::Heading2::roverID
+        /// \return Rover or \c nullptr if no solution of this rover was received
+        const Rover* find(const char* id) const;
+        /// \brief Forget all rovers
+        inline void clear() { _count = 0; }
+    public:
+        /// \return Number of rovers
+        inline size_t size() const { return _count; }
+        /// \return Capacity
+        static constexpr size_t capacity() { return OEM7_ROVERS; }
+        /// \return Number of solutions of rovers that did not fit into the table
+        inline uint32_t overflow() const { return _overflow; }
+        /// \param idx Rover index (less than \c size())
+        /// \return Rover
+        inline const Rover& operator [] (const size_t idx) const { return _rovers[idx]; }
+        /// \return First rover
+        inline const Rover* begin() const { return &_rovers[0]; }
+        /// \return Rover after the last one
+        inline const Rover* end() const { return &_rovers[_count]; }
+    private:
+        /// \return Index of rover or \c size() if not found
+        size_t index(const uint32_t key) const;
+        /// \return 32-bit key of rover ID
+        static uint32_t key(const char* id);
+    private:
+        uint32_t _keys[OEM7_ROVERS]{};
+        Rover _rovers[OEM7_ROVERS];
+        size_t _count{ 0 };
+        uint32_t _overflow{ 0 };
+    };
+}
+
+#endif // __OEM7_ROVERS_H__
@@ -0,0 +1,69 @@
+/// \file       SeqLock.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_SEQLOCK_H__
+#define __OEM7_SEQLOCK_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <type_traits>
+
+namespace oem7 {
+    /// \class oem7::SeqLock SeqLock.h
+    /// \brief Sequence lock protected value
+    /// \details One writer, any number of readers on any cores. Readers never block the writer:
+    /// \details a read that overlaps a write is retried, so it always returns a value of one \c store()
+    /// \details Value is kept as relaxed atomic words, so concurrent copy is not a data race
+    /// \tparam T Trivially copyable value
+    /// \ingroup oem7rec
+    template <typename T>
+    class SeqLock {
+        static_assert(std::is_trivially_copyable<T>::value, "SeqLock value must be trivially copyable");
+        SeqLock(const SeqLock&) = delete;
+        SeqLock& operator = (const SeqLock&) = delete;
+    public:
+        /// \brief Constructor
+        SeqLock() {}
+    public:
+        /// \brief Publish value (writer side)
+        /// \param value Value
+        void store(const T& value)
+        {
+            uint32_t words[WORDS] = { 0 };
+            memcpy(&words[0], &value, sizeof(T));
+            const uint32_t seq = _seq.load(std::memory_order_relaxed);
+            _seq.store(seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < WORDS; ++i) _data[i].store(words[i], std::memory_order_relaxed);
+            _seq.store(seq + 2, std::memory_order_release);
+        }
+        /// \brief Read consistent value (reader side)
+        /// \return Value of the last completed \c store()
+        T load() const
+        {
+            uint32_t words[WORDS];
+            uint32_t begin, end;
+            do {
+                begin = _seq.load(std::memory_order_acquire);
+                for (size_t i = 0; i < WORDS; ++i) words[i] = _data[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                end = _seq.load(std::memory_order_relaxed);
+            } while ((begin & 1) != 0 || begin != end);
+            T value;
+            memcpy(static_cast<void*>(&value), &words[0], sizeof(T));
+            return value;
+        }
+        /// \return Number of completed \c store() calls
+        inline uint32_t version() const { return _seq.load(std::memory_order_acquire) >> 1; }
+    private:
+        static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+        std::atomic<uint32_t> _seq{ 0 };
+        std::atomic<uint32_t> _data[WORDS]{};
+    };
+}
+
+#endif // __OEM7_SEQLOCK_H__
@@ -0,0 +1,172 @@
+/// \file       Stats.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_STATS_H__
+#define __OEM7_STATS_H__
+
+#include "Config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/// \def OEM7_STATS_MESSAGES
+/// \brief Number of message IDs counted separately by oem7::ReceiverStats
+/// \details Declare in build flags to override
+#ifndef OEM7_STATS_MESSAGES
+# define OEM7_STATS_MESSAGES 8
+#endif
+/// \def OEM7_STATS_BUCKETS
+/// \brief Number of oem7::Histogram buckets
+/// \details Bucket 0 counts 0 us, bucket \c i counts [2^(i-1), 2^i) us, the last bucket counts everything longer
+#ifndef OEM7_STATS_BUCKETS
+# define OEM7_STATS_BUCKETS 16
+#endif
+/// \def OEM7_LATENCY_WINDOW
+/// \brief Window of the latency baseline (in ms)
+/// \details Host and receiver clocks drift apart, so the fastest frame is searched again in each window.
+/// \details Declare in build flags to override
+#ifndef OEM7_LATENCY_WINDOW
+# define OEM7_LATENCY_WINDOW 10000
+#endif
+
+namespace oem7 {
+    /// \struct oem7::Histogram Stats.h
+    /// \brief Fixed-bucket duration histogram (power of two microsecond bounds)
+    /// \ingroup oem7rec
+    struct Histogram {
+        uint32_t bucket[OEM7_STATS_BUCKETS]{};  ///< Number of samples by bucket
+        uint32_t count{ 0 };                    ///< Number of samples
+        uint32_t max{ 0 };                      ///< Longest sample (us)
+        uint64_t total{ 0 };                    ///< Sum of samples (us)
+        /// \brief Add sample
+        /// \param us Duration (us)
+        void add(const uint32_t us)
+        {
+            size_t i = 0;
+            while (i < OEM7_STATS_BUCKETS - 1 && (us >> i) != 0) ++i;
+            ++bucket[i];
+            ++count;
+            total += us;
+            if (us > max) max = us;
+        }
+        /// \param i Bucket
+        /// \return Upper bound of bucket (us), \c UINT32_MAX for the last one
+        static constexpr uint32_t upper(const size_t i)
+        {
+            return i >= OEM7_STATS_BUCKETS - 1 ? UINT32_MAX : (static_cast<uint32_t>(1) << i);
+        }
+        /// \return Mean sample (us)
+        inline uint32_t mean() const { return count ? static_cast<uint32_t>(total / count) : 0; }
+        /// \param p Fraction of samples, for example 0.99
+        /// \return Upper bound of the bucket holding the \c p quantile (us)
+        uint32_t quantile(const double p) const
+        {
+            const double need = p * count;
+            uint32_t sum = 0;
+            for (size_t i = 0; i < OEM7_STATS_BUCKETS; ++i) {
+                sum += bucket[i];
+                if (sum >= need && sum > 0) return i == OEM7_STATS_BUCKETS - 1 ? max : upper(i);
+            }
+            return max;
+        }
+    };
+    /// \struct oem7::MessageStats Stats.h
+    /// \brief Counters of one message ID
+    /// \ingroup oem7rec
+    struct MessageStats {
+        uint16_t msgId{ 0 };        ///< Message ID, 0 - free slot
+        uint32_t received{ 0 };     ///< Frames with valid CRC
+        uint32_t crc{ 0 };          ///< CRC failures
+        uint32_t size{ 0 };         ///< Frames too long for the buffer or of wrong body size
+        uint32_t latency{ 0 };      ///< Latency of the latest frame with fine GPS time (us), see oem7::EpochClock
+    };
+    /// \class oem7::EpochClock Stats.h
+    /// \brief Transport and parse latency from the GPS epoch of the header and the host receive time
+    /// \details Host clock is not synchronized to GPS time, so the offset between them is taken from the fastest
+    /// \details frame: latency is the delay above it. It grows with serial congestion and receiver output queueing,
+    /// \details constant delay (the fastest frame) is not included. Baseline is the fastest frame of the previous
+    /// \details \c OEM7_LATENCY_WINDOW or a faster one. Times are taken modulo 2^32 us, no 64-bit host clock needed
+    /// \ingroup oem7rec
+    class EpochClock {
+    public:
+        /// \brief Latency of frame
+        /// \param week GPS reference week of the header
+        /// \param ms Milliseconds of the GPS reference week of the header
+        /// \param received Host monotonic receive time (us)
+        /// \return Latency (us)
+        uint32_t latency(const uint16_t week, const uint32_t ms, const uint32_t received)
+        {
+            const uint32_t epoch = static_cast<uint32_t>((static_cast<uint64_t>(week) * 604800000u + ms) * 1000u);
+            const uint32_t offset = received - epoch;
+            if (!_started) {
+                _started = true;
+                _base = offset;
+                _fastest = offset;
+                _window = received;
+            }
+            // Signed differences: both clocks wrap modulo 2^32 us
+            if (static_cast<int32_t>(offset - _fastest) < 0) _fastest = offset;
+            if (static_cast<int32_t>(offset - _base) < 0) _base = offset;
+            if (received - _window >= static_cast<uint32_t>(OEM7_LATENCY_WINDOW) * 1000u) {
+                _base = _fastest;
+                _fastest = offset;
+                _window = received;
+            }
+            return offset - _base;
+        }
+    private:
+        uint32_t _base{ 0 };
+        uint32_t _fastest{ 0 };
+        uint32_t _window{ 0 };
+        bool _started{ false };
+    };
+    /// \struct oem7::ReceiverStats Stats.h
+    /// \brief Parser counters and timing
+    /// \details Read by \c Receiver::stats() as one consistent copy
+    /// \ingroup oem7rec
+    struct ReceiverStats {
+        MessageStats messages[OEM7_STATS_MESSAGES]; ///< Counters by message ID in order of arrival
+        uint32_t other{ 0 };        ///< Frames of message IDs beyond \c OEM7_STATS_MESSAGES, CRC and size failures of IDs never received valid
+        uint32_t frames{ 0 };       ///< Frames with valid CRC (logs and command responses)
+        uint32_t crc{ 0 };          ///< CRC failures
+        uint32_t headSize{ 0 };     ///< Frames of unsupported header length
+        uint32_t oversize{ 0 };     ///< Frames too long for the frame buffer
+        uint32_t discarded{ 0 };    ///< Bytes outside binary frames: resync and ASCII replies
+        uint32_t readErrors{ 0 };   ///< Failed serial reads
+        uint32_t overruns{ 0 };     ///< Messages dropped by the background reader (see \c Receiver::dropped())
+        Histogram parse;            ///< Time of \c Receiver::read() returning a frame: serial read and parse
+        Histogram update;           ///< Time of \c Receiver::update()
+        Histogram latency;          ///< Latency of frames with fine GPS time: GPS epoch to host receive, see oem7::EpochClock
+        uint8_t idle{ 0 };          ///< Receiver CPU idle time of the latest frame (0-200, divide by two for %)
+        uint8_t idleMin{ 200 };     ///< The lowest receiver CPU idle time (0-200)
+        /// \param msgId Message ID
+        /// \return Counters of message, a free slot is taken for a new ID, \c nullptr if table is full
+        MessageStats* message(const uint16_t msgId)
+        {
+            for (MessageStats& m : messages) {
+                if (m.msgId == msgId) return &m;
+                if (m.msgId == 0) {
+                    m.msgId = msgId;
+                    return &m;
+                }
+            }
+            return nullptr;
+        }
+        /// \param msgId Message ID
+        /// \return Counters of message or \c nullptr if it was not received
+        const MessageStats* find(const uint16_t msgId) const
+        {
+            for (const MessageStats& m : messages) {
+                if (m.msgId == 0) break;
+                if (m.msgId == msgId) return &m;
+            }
+            return nullptr;
+        }
+        /// \param msgId Message ID
+        /// \return Counters of message or \c nullptr if it was not received, no slot is taken
+        inline MessageStats* find(const uint16_t msgId) { return const_cast<MessageStats*>(static_cast<const ReceiverStats*>(this)->find(msgId)); }
+    };
+}
+
+#endif // __OEM7_STATS_H__
@@ -0,0 +1,538 @@
+/// \file       Transport.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#if defined(_WIN32) && !defined(ESP8266) && !defined(ESP32)
+// Before windows.h of serialib: it would include winsock.h
+# include <winsock2.h>
+# include <ws2tcpip.h>
+# ifdef _MSC_VER
+#  pragma comment(lib, "ws2_32.lib")
+# endif
+#endif
+#include "Transport.h"
+#include "Capture.h"
+#include <string.h>
+
+#if !defined(ESP8266) && !defined(ESP32)
+# include <stdio.h>
+# include <chrono>
+# if !defined(_WIN32)
+#  include <errno.h>
+#  include <fcntl.h>
+#  include <netdb.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <poll.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+# endif
+#endif
+
+int oem7::MemoryTransport::read(uint8_t* data, size_t size)
+{
+	const size_t n = size < _size - _pos ? size : _size - _pos;
+	if (n == 0) return 0;
+	memcpy(data, &_data[_pos], n);
+	_pos += n;
+	return static_cast<int>(n);
+}
+
+#if defined(ESP8266) || defined(ESP32)
+oem7::SerialTransport::~SerialTransport()
+{
+#if defined(ESP32)
+	if (_wake != nullptr) {
+		_serial.onReceive(nullptr);
+		vSemaphoreDelete(_wake);
+	}
+#endif
+}
+
+int oem7::SerialTransport::read(uint8_t* data, size_t size)
+{
+	const size_t available = static_cast<size_t>(_serial.available());
+	if (available == 0 || size == 0) return 0;
+	const size_t n = _serial.readBytes(data, available < size ? available : size);
+	return n > 0 ? static_cast<int>(n) : -1;
+}
+
+size_t oem7::SerialTransport::write(const uint8_t* data, size_t size)
+{
+	return _serial.write(data, size);
+}
+
+bool oem7::SerialTransport::wait(const unsigned long timeout)
+{
+	if (_serial.available() > 0) return true;
+#if defined(ESP32)
+	// UART driver receive event (FIFO threshold or line idle) wakes the waiting task
+	if (_wake == nullptr) {
+		_wake = xSemaphoreCreateBinary();
+		if (_wake == nullptr) return false;
+		_serial.onReceive([this]() { xSemaphoreGive(_wake); }, false);
+	}
+	const unsigned long ms = millis();
+	while (_serial.available() == 0) {
+		const unsigned long elapsed = millis() - ms;
+		if (elapsed >= timeout) return false;
+		const TickType_t ticks = pdMS_TO_TICKS(timeout - elapsed);
+		xSemaphoreTake(_wake, ticks > 0 ? ticks : 1);
+	}
+	return true;
+#else
+	unsigned long ms = millis();
+	if (static_cast<unsigned long>(ms + timeout) == 0) ms = 0;
+	while (_serial.available() == 0) {
+		if (millis() - ms > timeout) return false;
+		yield();
+	}
+	return true;
+#endif
+}
+
+bool oem7::SerialTransport::setBaud(const uint32_t baud)
+{
+	_serial.flush();
+	_serial.updateBaudRate(baud);
+	while (_serial.available() > 0) _serial.read();
+	return true;
+}
+
+uint32_t oem7::SerialTransport::baudRate() const
+{
+	return _serial.baudRate();
+}
+#else
+oem7::SerialTransport::~SerialTransport()
+{
+#if !defined(_WIN32)
+	if (_watch >= 0) ::close(_watch);
+#endif
+}
+
+int oem7::SerialTransport::read(uint8_t* data, size_t size)
+{
+	if (size == 0) return 0;
+	size_t n = 0;
+	if (_pending >= 0) {
+		data[n++] = static_cast<uint8_t>(_pending);
+		_pending = -1;
+	}
+	const size_t available = static_cast<size_t>(_serial.available());
+	if (available == 0 || n == size) return static_cast<int>(n);
+	const int read = _serial.readBytes(&data[n], static_cast<unsigned int>(available < size - n ? available : size - n));
+	if (read <= 0) return n > 0 ? static_cast<int>(n) : -1;
+	return static_cast<int>(n + static_cast<size_t>(read));
+}
+
+size_t oem7::SerialTransport::write(const uint8_t* data, size_t size)
+{
+	return _serial.writeBytes(data, static_cast<unsigned int>(size)) == 1 ? size : 0;
+}
+
+bool oem7::SerialTransport::wait(const unsigned long timeout)
+{
+	if (_pending >= 0 || _serial.available() > 0) return true;
+	if (timeout == 0) return false;
+#if !defined(_WIN32)
+	if (_watch >= 0) {
+		pollfd fd{ _watch, POLLIN, 0 };
+		const int ms = timeout > 0x7FFFFFFF ? 0x7FFFFFFF : static_cast<int>(timeout);
+		return ::poll(&fd, 1, ms) > 0 && (fd.revents & POLLIN) != 0;
+	}
+#endif
+	// Timed read of the first byte: kernel wait by COMMTIMEOUTS on Win32
+	uint8_t byte = 0;
+	if (_serial.readBytes(&byte, 1, static_cast<unsigned int>(timeout), 1000) != 1) return false;
+	_pending = byte;
+	return true;
+}
+
+bool oem7::SerialTransport::setBaud(const uint32_t baud)
+{
+	if (_device == nullptr) return false;
+	_serial.closeDevice();
+	_pending = -1;
+	if (_serial.openDevice(_device, baud) != 1) return false;
+	_serial.flushReceiver();
+	_baud = baud;
+	return true;
+}
+
+uint32_t oem7::SerialTransport::baudRate() const
+{
+	return _baud;
+}
+
+#if !defined(_WIN32)
+bool oem7::SerialTransport::watch(const char* device)
+{
+	if (_watch >= 0) ::close(_watch);
+	// Poll only: never read, so serialib keeps all the data
+	_watch = ::open(device, O_RDONLY | O_NOCTTY | O_NONBLOCK);
+	return _watch >= 0;
+}
+#endif
+
+namespace {
+	const uint8_t captureHeader[oem7::CAPTURE_HEADER] = { 'O', 'E', 'M', '7', 'C', 'A', 'P', oem7::CAPTURE_VERSION };
+
+#if defined(_WIN32)
+	typedef SOCKET Socket;
+	const Socket NO_SOCKET = INVALID_SOCKET;
+
+	bool startup()
+	{
+		static const bool ready = []() {
+			WSADATA data;
+			return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+		}();
+		return ready;
+	}
+
+	void closeSocket(const Socket s)
+	{
+		::closesocket(s);
+	}
+
+	bool nonBlocking(const Socket s)
+	{
+		u_long on = 1;
+		return ::ioctlsocket(s, FIONBIO, &on) == 0;
+	}
+
+	bool wouldBlock()
+	{
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+	}
+
+	bool connecting()
+	{
+		return WSAGetLastError() == WSAEWOULDBLOCK;
+	}
+
+	bool refused()
+	{
+		// ICMP port unreachable of a connected UDP socket
+		return WSAGetLastError() == WSAECONNRESET;
+	}
+
+	int pollSocket(const Socket s, const short events, const unsigned long timeout)
+	{
+		WSAPOLLFD fd{ s, events, 0 };
+		const int ms = timeout > 0x7FFFFFFF ? 0x7FFFFFFF : static_cast<int>(timeout);
+		// Error and hang up wake up too: the next call reports them
+		return ::WSAPoll(&fd, 1, ms) > 0 && (fd.revents & (events | POLLERR | POLLHUP)) != 0;
+	}
+#else
+	typedef int Socket;
+	const Socket NO_SOCKET = -1;
+
+	bool startup()
+	{
+		return true;
+	}
+
+	void closeSocket(const Socket s)
+	{
+		::close(s);
+	}
+
+	bool nonBlocking(const Socket s)
+	{
+		const int flags = ::fcntl(s, F_GETFL, 0);
+		return flags >= 0 && ::fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+	}
+
+	bool wouldBlock()
+	{
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+	}
+
+	bool connecting()
+	{
+		return errno == EINPROGRESS || errno == EINTR;
+	}
+
+	bool refused()
+	{
+		// ICMP port unreachable of a connected UDP socket
+		return errno == ECONNREFUSED;
+	}
+
+	int pollSocket(const Socket s, const short events, const unsigned long timeout)
+	{
+		pollfd fd{ s, events, 0 };
+		const int ms = timeout > 0x7FFFFFFF ? 0x7FFFFFFF : static_cast<int>(timeout);
+		// Error and hang up wake up too: the next call reports them
+		return ::poll(&fd, 1, ms) > 0 && (fd.revents & (events | POLLERR | POLLHUP)) != 0;
+	}
+#endif
+#ifdef MSG_NOSIGNAL
+	const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+	const int SEND_FLAGS = 0;
+#endif
+
+	/// \brief Non-blocking connect, bounded by timeout
+	bool connectSocket(const Socket s, const sockaddr* address, const socklen_t size, const unsigned long timeout)
+	{
+		if (!nonBlocking(s)) return false;
+		if (::connect(s, address, size) == 0) return true;
+		if (!connecting() || !pollSocket(s, POLLOUT, timeout)) return false;
+		int error = 0;
+		socklen_t length = sizeof(error);
+		return ::getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &length) == 0 && error == 0;
+	}
+
+	/// \return Connected socket or \c NO_SOCKET
+	Socket openSocket(const char* host, const uint16_t port, const int type, const uint16_t localPort, const unsigned long timeout)
+	{
+		if (!startup()) return NO_SOCKET;
+		char service[8];
+		snprintf(service, sizeof(service), "%u", static_cast<unsigned>(port));
+		addrinfo hints;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = type;
+		addrinfo* list = nullptr;
+		if (::getaddrinfo(host, service, &hints, &list) != 0) return NO_SOCKET;
+		Socket result = NO_SOCKET;
+		for (addrinfo* ai = list; ai != nullptr && result == NO_SOCKET; ai = ai->ai_next) {
+			const Socket s = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+			if (s == NO_SOCKET) continue;
+			bool ok = true;
+			if (localPort != 0) {
+				// Local port of the stream the receiver sends to
+				sockaddr_storage local;
+				memset(&local, 0, sizeof(local));
+				socklen_t size = 0;
+				if (ai->ai_family == AF_INET6) {
+					sockaddr_in6* in6 = reinterpret_cast<sockaddr_in6*>(&local);
+					in6->sin6_family = AF_INET6;
+					in6->sin6_port = htons(localPort);
+					size = sizeof(sockaddr_in6);
+				} else {
+					sockaddr_in* in = reinterpret_cast<sockaddr_in*>(&local);
+					in->sin_family = AF_INET;
+					in->sin_port = htons(localPort);
+					size = sizeof(sockaddr_in);
+				}
+				ok = ::bind(s, reinterpret_cast<sockaddr*>(&local), size) == 0;
+			}
+			// Non-blocking connect and reads
+			ok = ok && connectSocket(s, ai->ai_addr, static_cast<socklen_t>(ai->ai_addrlen), timeout);
+			if (ok) result = s;
+			else closeSocket(s);
+		}
+		::freeaddrinfo(list);
+		return result;
+	}
+
+	/// \return Bytes read, 0 if none, -1 on error or close by the peer
+	int receive(const intptr_t s, uint8_t* data, const size_t size, const bool datagram)
+	{
+		const int n = static_cast<int>(::recv(static_cast<Socket>(s), reinterpret_cast<char*>(data), static_cast<int>(size), 0));
+		if (n > 0) return n;
+		if (n == 0) return datagram ? 0 : -1;
+		// Datagram peer may start later, a refused or reset stream is closed
+		return wouldBlock() || (datagram && refused()) ? 0 : -1;
+	}
+
+	size_t send(const intptr_t s, const uint8_t* data, const size_t size)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		size_t sent = 0;
+		while (sent < size) {
+			const int n = static_cast<int>(::send(static_cast<Socket>(s), reinterpret_cast<const char*>(&data[sent]), static_cast<int>(size - sent), SEND_FLAGS));
+			if (n > 0) {
+				sent += static_cast<size_t>(n);
+				continue;
+			}
+			// Socket buffer is full: wait a bit, give up after 100 ms. Error or refused datagram: give up now
+			if (n < 0 && !wouldBlock()) break;
+			if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(100)) break;
+			pollSocket(static_cast<Socket>(s), POLLOUT, 10);
+		}
+		return sent;
+	}
+}
+
+bool oem7::TcpTransport::connect(const char* host, const uint16_t port, const unsigned long timeout)
+{
+	close();
+	const Socket s = openSocket(host, port, SOCK_STREAM, 0, timeout);
+	if (s == NO_SOCKET) return false;
+	// Commands are short: no Nagle delay
+	const int on = 1;
+	::setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+	_socket = static_cast<intptr_t>(s);
+	return true;
+}
+
+void oem7::TcpTransport::close()
+{
+	if (_socket < 0) return;
+	closeSocket(static_cast<Socket>(_socket));
+	_socket = -1;
+}
+
+int oem7::TcpTransport::read(uint8_t* data, size_t size)
+{
+	if (_socket < 0 || size == 0) return 0;
+	const int n = receive(_socket, data, size, false);
+	// Closed or reset by the peer, or failed
+	if (n < 0) close();
+	return n;
+}
+
+size_t oem7::TcpTransport::write(const uint8_t* data, size_t size)
+{
+	return _socket >= 0 ? send(_socket, data, size) : 0;
+}
+
+bool oem7::TcpTransport::wait(const unsigned long timeout)
+{
+	return _socket >= 0 && pollSocket(static_cast<Socket>(_socket), POLLIN, timeout);
+}
+
+bool oem7::UdpTransport::open(const char* host, const uint16_t port, const uint16_t localPort)
+{
+	close();
+	// Datagram connect only sets the peer
+	const Socket s = openSocket(host, port, SOCK_DGRAM, localPort, 0);
+	if (s == NO_SOCKET) return false;
+	_socket = static_cast<intptr_t>(s);
+	return true;
+}
+
+void oem7::UdpTransport::close()
+{
+	if (_socket >= 0) closeSocket(static_cast<Socket>(_socket));
+	_socket = -1;
+	_pos = 0;
+	_len = 0;
+}
+
+int oem7::UdpTransport::read(uint8_t* data, size_t size)
+{
+	if (_socket < 0 || size == 0) return 0;
+	if (_pos == _len) {
+		// Whole datagram: a shorter read would drop its tail
+		const int n = receive(_socket, &_datagram[0], sizeof(_datagram), true);
+		if (n <= 0) return n;
+		_pos = 0;
+		_len = static_cast<size_t>(n);
+	}
+	const size_t n = _len - _pos < size ? _len - _pos : size;
+	memcpy(data, &_datagram[_pos], n);
+	_pos += n;
+	return static_cast<int>(n);
+}
+
+size_t oem7::UdpTransport::write(const uint8_t* data, size_t size)
+{
+	return _socket >= 0 ? send(_socket, data, size) : 0;
+}
+
+bool oem7::UdpTransport::wait(const unsigned long timeout)
+{
+	if (_pos < _len) return true;
+	return _socket >= 0 && pollSocket(static_cast<Socket>(_socket), POLLIN, timeout);
+}
+
+bool oem7::FileTransport::open(const char* path)
+{
+	close();
+#if defined(_WIN32)
+	HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	HANDLE mapping = nullptr;
+	if (::GetFileSizeEx(file, &size) && size.QuadPart > 0) mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	const void* data = mapping != nullptr ? ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (data == nullptr) {
+		if (mapping != nullptr) ::CloseHandle(mapping);
+		::CloseHandle(file);
+		return false;
+	}
+	_file = file;
+	_mapping = mapping;
+	_data = static_cast<const uint8_t*>(data);
+	_size = static_cast<size_t>(size.QuadPart);
+#else
+	const int fd = ::open(path, O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st;
+	void* data = MAP_FAILED;
+	if (::fstat(fd, &st) == 0 && st.st_size > 0) data = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	// Mapping keeps the file
+	::close(fd);
+	if (data == MAP_FAILED) return false;
+	::madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+	_data = static_cast<const uint8_t*>(data);
+	_size = static_cast<size_t>(st.st_size);
+#endif
+	_capture = _size >= sizeof(captureHeader) && memcmp(_data, &captureHeader[0], sizeof(captureHeader)) == 0;
+	rewind();
+	return true;
+}
+
+void oem7::FileTransport::close()
+{
+	if (_data == nullptr) return;
+#if defined(_WIN32)
+	::UnmapViewOfFile(_data);
+	::CloseHandle(_mapping);
+	::CloseHandle(_file);
+	_mapping = nullptr;
+	_file = nullptr;
+#else
+	::munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+	_data = nullptr;
+	_size = 0;
+	_pos = 0;
+}
+
+void oem7::FileTransport::rewind()
+{
+	_pos = _capture ? CAPTURE_HEADER : 0;
+	_record = 0;
+}
+
+int oem7::FileTransport::read(uint8_t* data, size_t size)
+{
+	size_t n = 0;
+	while (n < size && _pos < _size) {
+		if (_capture && _record == 0) {
+			// File header of a capture appended to this one
+			if (_size - _pos >= CAPTURE_HEADER && memcmp(&_data[_pos], &captureHeader[0], CAPTURE_HEADER) == 0) {
+				_pos += CAPTURE_HEADER;
+				continue;
+			}
+			// Record header: time and payload size
+			if (_size - _pos < CAPTURE_RECORD_HEAD) {
+				_pos = _size;
+				break;
+			}
+			uint16_t length = 0;
+			memcpy(&length, &_data[_pos + sizeof(uint32_t)], sizeof(length));
+			_pos += CAPTURE_RECORD_HEAD;
+			_record = length;
+			continue;
+		}
+		size_t chunk = size - n < _size - _pos ? size - n : _size - _pos;
+		if (_capture && chunk > _record) chunk = _record;
+		memcpy(&data[n], &_data[_pos], chunk);
+		n += chunk;
+		_pos += chunk;
+		if (_capture) _record -= chunk;
+	}
+	return static_cast<int>(n);
+}
+#endif
@@ -0,0 +1,270 @@
+/// \file       Transport.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_TRANSPORT_H__
+#define __OEM7_TRANSPORT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#if defined(ESP8266) || defined(ESP32)
+#include "HardwareSerial.h"
+#if defined(ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#endif
+#define SERIALPORT HardwareSerial
+#else
+#include <serialib.h>
+#define SERIALPORT serialib
+#endif
+
+/// \def OEM7_DATAGRAM
+/// \brief The longest UDP datagram of oem7::UdpTransport (in bytes)
+/// \details Declare in build flags to override
+#ifndef OEM7_DATAGRAM
+# define OEM7_DATAGRAM 2048
+#endif
+/// \def OEM7_CONNECT_TIMEOUT
+/// \brief TCP connect timeout of oem7::TcpTransport (in ms)
+#ifndef OEM7_CONNECT_TIMEOUT
+# define OEM7_CONNECT_TIMEOUT 3000
+#endif
+
+/// \defgroup oem7link OEM7 Transport
+/// \brief Byte transports of oem7::BasicReceiver
+/// \details A transport is any class with these members, chosen by the template parameter of oem7::BasicReceiver,
+/// \details so transport calls are direct (and inlined within a translation unit), never virtual:
+/// \details - \c int \c read(uint8_t* data, size_t size): bytes available now, up to \c size, never blocks; -1 on error
+/// \details - \c size_t \c write(const uint8_t* data, size_t size): send all bytes
+/// \details - \c bool \c wait(unsigned long timeout): sleep until bytes are available, \c false on timeout (ms)
+/// \details - \c bool \c setBaud(uint32_t baud): switch baud rate and drop received bytes, \c false if not a serial port
+/// \details - \c uint32_t \c baudRate(): current baud rate, 0 if not a serial port
+
+namespace oem7 {
+    /// \class oem7::SerialTransport Transport.h
+    /// \brief Serial port: \c HardwareSerial on Arduino, \c serialib on Win32 and POSIX
+    /// \details Waits sleep in the kernel: UART receive event on ESP32, \c poll() or timed read on Win32 and POSIX
+    /// \ingroup oem7link
+    class SerialTransport {
+        SerialTransport() = delete;
+        SerialTransport(const SerialTransport&) = delete;
+        SerialTransport& operator = (const SerialTransport&) = delete;
+    public:
+        /// \brief Constructor
+        /// \param serial Serial interface reference
+        explicit SerialTransport(SERIALPORT& serial) : _serial(serial) {}
+        /// \brief Destructor
+        ~SerialTransport();
+    public:
+        /// \brief Read bytes available now
+        int read(uint8_t* data, size_t size);
+        /// \brief Write bytes
+        size_t write(const uint8_t* data, size_t size);
+        /// \brief Wait for serial available
+        bool wait(const unsigned long timeout);
+        /// \brief Switch baud rate and drop bytes received at the old rate
+        /// \details Win32 and POSIX reopen the device set by \c device()
+        bool setBaud(const uint32_t baud);
+        /// \return Current baud rate, 0 if unknown
+        uint32_t baudRate() const;
+        /// \return Serial interface
+        inline SERIALPORT& serial() { return _serial; }
+#if !defined(ESP8266) && !defined(ESP32)
+        /// \brief Set device name used to reopen the port at another baud rate
+        /// \param name Device name passed to \c serialib::openDevice(), must stay valid
+        inline void device(const char* name) { _device = name; }
+#endif
+#if !defined(ESP8266) && !defined(ESP32) && !defined(_WIN32)
+        /// \brief Wait for serial data with \c poll()
+        /// \details serialib does not expose its descriptor, so the device is opened once more for polling only.
+        /// \details Without it waits fall back to serialib timed reads
+        /// \param device Device name passed to \c serialib::openDevice(), e.g. "/dev/ttyUSB0"
+        /// \return \c false if device could not be opened
+        bool watch(const char* device);
+        /// \return Descriptor of \c watch(), -1 if not watching
+        inline intptr_t handle() const { return _watch; }
+#endif
+    private:
+        SERIALPORT& _serial;
+#if defined(ESP32)
+        SemaphoreHandle_t _wake{ nullptr };
+#elif !defined(ESP8266)
+        const char* _device{ nullptr };
+        uint32_t _baud{ 0 };
+        int _pending{ -1 };     ///< Byte taken by the timed read, -1 - none
+#if !defined(_WIN32)
+        int _watch{ -1 };
+#endif
+#endif
+    };
+    /// \class oem7::MemoryTransport Transport.h
+    /// \brief Bytes in memory, e.g. a log in flash or a benchmark stream
+    /// \details Reads are copied from the buffer. Writes are discarded, commands time out
+    /// \ingroup oem7link
+    class MemoryTransport {
+        MemoryTransport(const MemoryTransport&) = delete;
+        MemoryTransport& operator = (const MemoryTransport&) = delete;
+    public:
+        /// \brief Constructor
+        MemoryTransport() {}
+        /// \brief Constructor
+        /// \param data Bytes, must outlive the transport
+        /// \param size Number of bytes
+        MemoryTransport(const uint8_t* data, const size_t size) : _data(data), _size(size) {}
+    public:
+        /// \brief Set bytes and read from the start
+        /// \param data Bytes, must outlive the transport
+        /// \param size Number of bytes
+        inline void assign(const uint8_t* data, const size_t size) { _data = data; _size = size; _pos = 0; }
+        /// \return All bytes are read
+        inline bool atEnd() const { return _pos >= _size; }
+        /// \brief Read from the start again
+        inline void rewind() { _pos = 0; }
+    public:
+        /// \brief Read next bytes
+        int read(uint8_t* data, size_t size);
+        /// \brief Discard bytes
+        inline size_t write(const uint8_t* data, size_t size) { (void)data; return size; }
+        /// \return Bytes are left
+        inline bool wait(const unsigned long timeout) { (void)timeout; return !atEnd(); }
+        /// \brief Not a serial port
+        inline bool setBaud(const uint32_t baud) { (void)baud; return false; }
+        inline uint32_t baudRate() const { return 0; }
+    private:
+        const uint8_t* _data{ nullptr };
+        size_t _size{ 0 };
+        size_t _pos{ 0 };
+    };
+#if !defined(ESP8266) && !defined(ESP32)
+    /// \class oem7::TcpTransport Transport.h
+    /// \brief TCP client, e.g. OEM7 ICOM port over Ethernet
+    /// \details Reads are non-blocking, waits sleep in \c poll(). Close or reset by the peer reads as -1 and closes
+    /// \details the connection, see \c isOpen()
+    /// \ingroup oem7link
+    class TcpTransport {
+        TcpTransport(const TcpTransport&) = delete;
+        TcpTransport& operator = (const TcpTransport&) = delete;
+    public:
+        /// \brief Constructor
+        TcpTransport() {}
+        /// \brief Destructor
+        ~TcpTransport() { close(); }
+    public:
+        /// \brief Connect
+        /// \param host Host name or address, e.g. "192.168.1.10"
+        /// \param port Port, e.g. 3001 for ICOM1
+        /// \param timeout Connect timeout of each address of the host (in ms)
+        /// \return \c false if connection failed or timed out
+        bool connect(const char* host, const uint16_t port, const unsigned long timeout = OEM7_CONNECT_TIMEOUT);
+        /// \brief Close connection
+        void close();
+        /// \return Connection is open
+        inline bool isOpen() const { return _socket >= 0; }
+        /// \return Socket descriptor, -1 if closed
+        inline intptr_t handle() const { return _socket; }
+    public:
+        /// \brief Read bytes available now, closes connection on error, reset or close by the peer (returns -1)
+        int read(uint8_t* data, size_t size);
+        /// \brief Write bytes
+        size_t write(const uint8_t* data, size_t size);
+        /// \brief Wait for received data, error or close by the peer
+        bool wait(const unsigned long timeout);
+        /// \brief Not a serial port
+        inline bool setBaud(const uint32_t baud) { (void)baud; return false; }
+        inline uint32_t baudRate() const { return 0; }
+    private:
+        intptr_t _socket{ -1 };
+    };
+    /// \class oem7::UdpTransport Transport.h
+    /// \brief UDP stream, e.g. OEM7 ICOM port in UDP mode
+    /// \details Datagrams of the peer only, up to \c OEM7_DATAGRAM bytes. Commands are sent to the peer.
+    /// \details Port unreachable replies of a peer not started yet are not errors
+    /// \ingroup oem7link
+    class UdpTransport {
+        UdpTransport(const UdpTransport&) = delete;
+        UdpTransport& operator = (const UdpTransport&) = delete;
+    public:
+        /// \brief Constructor
+        UdpTransport() {}
+        /// \brief Destructor
+        ~UdpTransport() { close(); }
+    public:
+        /// \brief Bind local port and set the peer
+        /// \param host Peer host name or address
+        /// \param port Peer port
+        /// \param localPort Local port, 0 - any
+        /// \return \c false if socket could not be opened
+        bool open(const char* host, const uint16_t port, const uint16_t localPort = 0);
+        /// \brief Close socket
+        void close();
+        /// \return Socket is open
+        inline bool isOpen() const { return _socket >= 0; }
+        /// \return Socket descriptor, -1 if closed
+        inline intptr_t handle() const { return _socket; }
+    public:
+        /// \brief Read bytes available now, closes connection on error
+        int read(uint8_t* data, size_t size);
+        /// \brief Write bytes
+        size_t write(const uint8_t* data, size_t size);
+        /// \brief Wait for received data
+        bool wait(const unsigned long timeout);
+        /// \brief Not a serial port
+        inline bool setBaud(const uint32_t baud) { (void)baud; return false; }
+        inline uint32_t baudRate() const { return 0; }
+    private:
+        intptr_t _socket{ -1 };
+        uint8_t _datagram[OEM7_DATAGRAM];
+        size_t _pos{ 0 };
+        size_t _len{ 0 };
+    };
+    /// \class oem7::FileTransport Transport.h
+    /// \brief Memory-mapped file: raw OEM7 binary stream or capture of oem7::CaptureWriter
+    /// \details Reads walk the mapping, captures are read without their record headers. Writes are discarded,
+    /// \details commands time out: read the file by \c Receiver::update() without \c begin()
+    /// \ingroup oem7link
+    class FileTransport {
+        FileTransport(const FileTransport&) = delete;
+        FileTransport& operator = (const FileTransport&) = delete;
+    public:
+        /// \brief Constructor
+        FileTransport() {}
+        /// \brief Destructor
+        ~FileTransport() { close(); }
+    public:
+        /// \brief Map file
+        /// \param path File path
+        /// \return \c false if file could not be mapped
+        bool open(const char* path);
+        /// \brief Unmap file
+        void close();
+        /// \return All bytes are read
+        inline bool atEnd() const { return _pos >= _size; }
+        /// \brief Read from the start again
+        void rewind();
+    public:
+        /// \brief Read next bytes of the file
+        int read(uint8_t* data, size_t size);
+        /// \brief Discard bytes
+        inline size_t write(const uint8_t* data, size_t size) { (void)data; return size; }
+        /// \return Bytes are left
+        inline bool wait(const unsigned long timeout) { (void)timeout; return !atEnd(); }
+        /// \brief Not a serial port
+        inline bool setBaud(const uint32_t baud) { (void)baud; return false; }
+        inline uint32_t baudRate() const { return 0; }
+    private:
+        const uint8_t* _data{ nullptr };
+        size_t _size{ 0 };
+        size_t _pos{ 0 };
+        size_t _record{ 0 };    ///< Payload bytes left in the capture record
+        bool _capture{ false };
+#if defined(_WIN32)
+        void* _file{ nullptr };
+        void* _mapping{ nullptr };
+#endif
+    };
+#endif
+}
+
+#endif // __OEM7_TRANSPORT_H__
@@ -0,0 +1,140 @@
+/// \file       WarmStart.cpp
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#include "WarmStart.h"
+#include "Crc32.h"
+#include <string.h>
+
+#if defined(ESP32)
+# include <Preferences.h>
+#elif !defined(ESP8266)
+# include <stdio.h>
+#endif
+
+namespace {
+	/// \brief Stored record: layout of another build (size) or a torn write (CRC) is not used
+	struct WarmRecord {
+		uint32_t magic;
+		uint32_t size;
+		oem7::WarmState state;
+		uint32_t crc;
+	};
+
+	constexpr uint32_t WARM_MAGIC = 0x4D524157UL;  // "WARM"
+
+	void hash(oem7::Crc32& crc, const void* data, const size_t size)
+	{
+		crc.update(static_cast<const uint8_t*>(data), size);
+	}
+
+	uint32_t checksum(const WarmRecord& record)
+	{
+		return oem7::Crc32::compute(reinterpret_cast<const uint8_t*>(&record.state), sizeof(record.state));
+	}
+
+	bool valid(const WarmRecord& record)
+	{
+		// CRC detects torn writes, the count is checked on its own
+		const size_t capacity = sizeof(record.state.version) / sizeof(record.state.version[0]);
+		return record.magic == WARM_MAGIC && record.size == sizeof(record.state) && record.crc == checksum(record) &&
+			record.state.components <= capacity;
+	}
+
+	bool readRecord(const char* key, WarmRecord& record)
+	{
+#if defined(ESP32)
+		Preferences prefs;
+		if (!prefs.begin(OEM7_WARM_NAMESPACE, true)) return false;
+		const size_t n = prefs.getBytesLength(key) == sizeof(record) ? prefs.getBytes(key, &record, sizeof(record)) : 0;
+		prefs.end();
+		return n == sizeof(record);
+#elif defined(ESP8266)
+		(void)key;
+		(void)record;
+		return false;
+#else
+		FILE* file = fopen(key, "rb");
+		if (file == nullptr) return false;
+		const size_t n = fread(&record, 1, sizeof(record), file);
+		fclose(file);
+		return n == sizeof(record);
+#endif
+	}
+
+	bool writeRecord(const char* key, const WarmRecord& record)
+	{
+#if defined(ESP32)
+		Preferences prefs;
+		if (!prefs.begin(OEM7_WARM_NAMESPACE, false)) return false;
+		const size_t n = prefs.putBytes(key, &record, sizeof(record));
+		prefs.end();
+		return n == sizeof(record);
+#elif defined(ESP8266)
+		(void)key;
+		(void)record;
+		return false;
+#else
+		FILE* file = fopen(key, "wb");
+		if (file == nullptr) return false;
+		const size_t n = fwrite(&record, 1, sizeof(record), file);
+		return fclose(file) == 0 && n == sizeof(record);
+#endif
+	}
+}
+
+uint32_t oem7::provisionHash(const LogProfile& profile, const bool configure)
+{
+	// Fields one by one: structure padding is not hashed
+	Crc32 crc;
+	const uint32_t revision = OEM7_CONFIG_REVISION;
+	const uint8_t config = configure ? 1 : 0;
+	hash(crc, &revision, sizeof(revision));
+	hash(crc, &config, sizeof(config));
+	hash(crc, &profile.port, sizeof(profile.port));
+	for (size_t i = 0; i < profile.count; ++i) {
+		const LogRequest& log = profile.logs[i];
+		hash(crc, &log.msgId, sizeof(log.msgId));
+		hash(crc, &log.trigger, sizeof(log.trigger));
+		hash(crc, &log.period, sizeof(log.period));
+	}
+	// Masks are sent with RXSTATUSEVENT only (See: Receiver::begin())
+	if (profile.events != nullptr && profile.has(MSG_RXSTATUSEVENT)) hash(crc, &profile.events->mask[0], sizeof(profile.events->mask));
+	return crc.value();
+}
+
+bool oem7::WarmStore::load(const char* key, WarmState& state)
+{
+	WarmRecord record;
+	if (!readRecord(key, record) || !valid(record)) return false;
+	state = record.state;
+	return true;
+}
+
+bool oem7::WarmStore::save(const char* key, const WarmState& state)
+{
+	WarmRecord record{};
+	record.magic = WARM_MAGIC;
+	record.size = sizeof(record.state);
+	record.state = state;
+	record.crc = checksum(record);
+	// Flash wear: the same provisioning is not written again
+	WarmRecord stored;
+	if (readRecord(key, stored) && memcmp(&stored, &record, sizeof(record)) == 0) return true;
+	return writeRecord(key, record);
+}
+
+void oem7::WarmStore::erase(const char* key)
+{
+#if defined(ESP32)
+	Preferences prefs;
+	if (!prefs.begin(OEM7_WARM_NAMESPACE, false)) return;
+	prefs.remove(key);
+	prefs.end();
+#elif defined(ESP8266)
+	(void)key;
+#else
+	::remove(key);
+#endif
+}
@@ -0,0 +1,87 @@
+/// \file       WarmStart.h
+/// \brief      This file is part of OEM7 Heading
+///	\copyright  &copy; https://github.com/Ilushenko Oleksandr Ilushenko
+///	\author     Oleksandr Ilushenko
+/// \date       2024
+#ifndef __OEM7_WARMSTART_H__
+#define __OEM7_WARMSTART_H__
+
+#include "oem7.h"
+#include "LogProfile.h"
+#include "Registry.h"
+#include <stddef.h>
+
+/// \def OEM7_CONFIG_REVISION
+/// \brief Revision of \c Receiver::config() commands, part of the provisioning hash
+/// \details Increment when the commands of \c config() change, so cached receivers are provisioned again
+#ifndef OEM7_CONFIG_REVISION
+# define OEM7_CONFIG_REVISION 1
+#endif
+/// \def OEM7_WARM_KEY
+/// \brief Default cache key of \c Receiver::warmStart(): NVS key (up to 15 characters) on ESP32, file path on PC
+#ifndef OEM7_WARM_KEY
+# define OEM7_WARM_KEY "oem7warm"
+#endif
+/// \def OEM7_WARM_NAMESPACE
+/// \brief NVS namespace of the cache (ESP32)
+#ifndef OEM7_WARM_NAMESPACE
+# define OEM7_WARM_NAMESPACE "oem7"
+#endif
+/// \def OEM7_WARM_WAIT
+/// \brief Wait for the first profile log of a receiver still logging (in ms)
+/// \details Longer than the longest log period of the profile, otherwise a warm receiver is subscribed again
+#ifndef OEM7_WARM_WAIT
+# define OEM7_WARM_WAIT 1100
+#endif
+
+namespace oem7 {
+    /// \brief Start kind of \c Receiver::warmStart()
+    /// \ingroup oem7rec
+    enum StartKind : uint8_t {
+        START_COLD      = 0,    ///< Configured (if requested) and subscribed: cache written
+        START_SUBSCRIBE = 1,    ///< Receiver restarted with the saved configuration: subscribed only
+        START_WARM      = 2     ///< Receiver kept logging the profile: no command sent
+    };
+
+    /// \struct oem7::WarmState WarmStart.h
+    /// \brief Cached provisioning of a receiver
+    /// \ingroup oem7rec
+    struct WarmState {
+        uint32_t hash{ 0 };                 ///< Provisioning hash (See: oem7::provisionHash())
+        uint16_t receiverVersion{ 0 };      ///< Receiver software build number of the headers
+        uint16_t components{ 0 };           ///< Number of cached version components
+        Version version[MessageTraits<Version>::enabled ? MessageTraits<Version>::capacity : 1]{};  ///< Version components
+    };
+
+    /// \brief Hash of the commands sent by \c Receiver::config() and \c Receiver::begin()
+    /// \details CRC-32 of \c OEM7_CONFIG_REVISION, the \c configure flag, port, requests and status events
+    /// \param profile Log subscriptions
+    /// \param configure \c Receiver::config() is part of provisioning
+    /// \return Hash
+    uint32_t provisionHash(const LogProfile& profile, const bool configure);
+
+    /// \class oem7::WarmStore WarmStart.h
+    /// \brief Persistent storage of oem7::WarmState: NVS (\c Preferences) on ESP32, a file on PC
+    /// \details Records are checked by CRC-32. ESP8266 has no storage: \c load() fails, so every start is cold
+    /// \ingroup oem7rec
+    class WarmStore {
+        WarmStore() = delete;
+    public:
+        /// \brief Read cached provisioning
+        /// \param key NVS key (ESP32) or file path (PC)
+        /// \param state Cached provisioning
+        /// \return \c false if there is no valid record: missing, torn, of another layout or with too many components
+        static bool load(const char* key, WarmState& state);
+        /// \brief Write cached provisioning
+        /// \details Flash is not written when the stored record is the same
+        /// \param key NVS key (ESP32) or file path (PC)
+        /// \param state Provisioning
+        /// \return \c false on write error
+        static bool save(const char* key, const WarmState& state);
+        /// \brief Remove cached provisioning: the next start is cold
+        /// \param key NVS key (ESP32) or file path (PC)
+        static void erase(const char* key);
+    };
+}
+
+#endif // __OEM7_WARMSTART_H__
@@ -6,6 +6,7 @@
 #ifndef __OEM7_H__
 #define __OEM7_H__
 
+#include "Config.h"
 #if defined(ESP8266) || defined(ESP32)
 #include "Arduino.h"
 #else
@@ -38,7 +39,9 @@ namespace oem7 {
         HEAD_SYNC_1 	        = 0xAA, ///< Sync Byte 1
         HEAD_SYNC_2 	        = 0x44, ///< Sync Byte 2
         HEAD_SYNC_3 	        = 0x12, ///< Sync Byte 3
-        HEAD_LENGHT 	        = 0x1C 	///< Lenght
+        HEAD_LENGHT 	        = 0x1C, ///< Lenght
+        HEAD_SHORT_SYNC_3       = 0x13, ///< Sync Byte 3 of short header
+        HEAD_SHORT_LENGHT       = 0x0C  ///< Lenght of short header
     };
     /// \brief Message ID
     /// \details Messages for using in this library
@@ -49,10 +52,78 @@ namespace oem7 {
         MSG_RXSTATUS	        = 93,	///< Receiver status
         MSG_RXSTATUSEVENT       = 94,   ///< Status event indicator
         MSG_TIME		        = 101,	///< Time data
+        MSG_INSATTS             = 319,  ///< Short INS attitude (short header)
         MSG_HWMONITOR           = 963,  ///< Monitor hardware levels
         MSG_HEADING2            = 1335,	///< Heading information with multiple rovers
         MSG_DUALANTHEADING      = 2042  ///< Synchronous heading information for dual antenna product
     };
+    /// \brief Command ID
+    /// \details Commands encoded by this library in binary
+    /// \ingroup oem7data
+    enum {
+        MSG_LOG                 = 1,    ///< Request logs from the receiver
+        MSG_UNLOGALL            = 38,   ///< Remove all logs from logging control
+        MSG_STATUSCONFIG        = 95,   ///< Configure RXSTATUSEVENT mask fields
+        MSG_SERIALCONFIG        = 1246, ///< Configure serial port settings
+        MSG_ANTENNATYPE         = 1415  ///< Enter or remove user-defined antenna
+    };
+    /// \brief Message Type bits
+    /// \details https://docs.novatel.com/OEM7/Content/Messages/Binary.htm#MessageTypeByteFormat
+    /// \ingroup oem7data
+    enum {
+        MSGTYPE_RESPONSE        = 0x80  ///< Response bit: message is a response to a command
+    };
+    /// \brief Detailed Port Identifier
+    /// \details https://docs.novatel.com/OEM7/Content/Messages/Binary.htm#DetailedPortIdentifier
+    /// \ingroup oem7data
+    enum {
+        PORT_ALL                = 0x08, ///< All ports
+        PORT_COM1               = 0x20, ///< COM1
+        PORT_COM2               = 0x40, ///< COM2
+        PORT_COM3               = 0x60, ///< COM3
+        PORT_THISPORT           = 0xC0  ///< The port the command is received on
+    };
+    /// \brief Serial Port Identifier
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/SERIALCONFIG.htm#SerialPortIdentifiers
+    /// \ingroup oem7data
+    enum {
+        COMPORT_COM1            = 1,    ///< COM1
+        COMPORT_COM2            = 2,    ///< COM2
+        COMPORT_COM3            = 3,    ///< COM3
+        COMPORT_THISPORT        = 6     ///< The port the command is received on
+    };
+    /// \brief Log Trigger
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/LOG.htm
+    /// \ingroup oem7data
+    enum {
+        TRIGGER_ONNEW           = 0,    ///< When the message is updated
+        TRIGGER_ONCHANGED       = 1,    ///< When the message has changed
+        TRIGGER_ONTIME          = 2,    ///< Periodically
+        TRIGGER_ONNEXT          = 3,    ///< Next message only
+        TRIGGER_ONCE            = 4,    ///< Current message only
+        TRIGGER_ONMARK          = 5     ///< When a pulse is detected on the mark input
+    };
+    /// \brief STATUSCONFIG Mask Type
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/STATUSCONFIG.htm
+    /// \ingroup oem7data
+    enum {
+        STATUSCONFIG_PRIORITY   = 0,    ///< Priority mask: bits raise the error flag
+        STATUSCONFIG_SET        = 1,    ///< Set mask: RXSTATUSEVENT when bit is set
+        STATUSCONFIG_CLEAR      = 2     ///< Clear mask: RXSTATUSEVENT when bit is cleared
+    };
+    /// \brief ANTENNATYPE Action
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/ANTENNATYPE.htm
+    /// \ingroup oem7data
+    enum {
+        ANTENNA_ADD             = 1,    ///< Add user-defined antenna
+        ANTENNA_REMOVE          = 2     ///< Remove user-defined antenna
+    };
+    /// \brief Response ID
+    /// \details https://docs.novatel.com/OEM7/Content/Messages/Responses.htm
+    /// \ingroup oem7data
+    enum {
+        RESPONSE_OK             = 1     ///< Command accepted
+    };
     /// \brief Version Component Types
     /// \details https://docs.novatel.com/OEM7/Content/Logs/VERSION.htm#ComponentTypes
     /// \ingroup oem7data
@@ -186,6 +257,22 @@ namespace oem7 {
         UTC_VALID	            = 1,    ///< Valid
         UTC_WARNING	            = 2     ///< Warning (Indicates that the leap second value is used as a default due to the lack of an almanac)
     };
+    /// \brief GPS Reference Time Status
+    /// \details https://docs.novatel.com/OEM7/Content/Messages/GPS_Reference_Time_Statu.htm
+    /// \ingroup oem7data
+    enum {
+        GPSTIME_UNKNOWN             = 20,   ///< Time validity is unknown
+        GPSTIME_APPROXIMATE         = 60,   ///< Time is set approximately
+        GPSTIME_COARSEADJUSTING     = 80,   ///< Time is approaching coarse precision
+        GPSTIME_COARSE              = 100,  ///< Time is valid to coarse precision
+        GPSTIME_COARSESTEERING      = 120,  ///< Time is coarse set and is being steered
+        GPSTIME_FREEWHEELING        = 130,  ///< Position is lost and the range bias cannot be calculated
+        GPSTIME_FINEADJUSTING       = 140,  ///< Time is adjusting to fine precision
+        GPSTIME_FINE                = 160,  ///< Time has fine precision
+        GPSTIME_FINEBACKUPSTEERING  = 170,  ///< Time is fine set and is being steered by the backup system
+        GPSTIME_FINESTEERING        = 180,  ///< Time is fine set and is being steered
+        GPSTIME_SATTIME             = 200   ///< Time from satellite, used in logs with no reference time (e.g. ephemeris)
+    };
     /// \brief Solution Status
     /// \details https://docs.novatel.com/OEM7/Content/Logs/BESTPOS.htm#SolutionStatus
     /// \ingroup oem7data
@@ -264,6 +351,18 @@ namespace oem7 {
         uint16_t reserved;			///< Reserved for internal use
         uint16_t receiverVersion;	///< A value (0 - 65535) representing the receiver software build number
     };
+    /// \struct oem7::ShortHead oem7.h
+    /// \brief Short binary message header structure
+    /// \details Follows sync bytes \c 0xAA \c 0x44 \c 0x13 of high-rate logs (\c INSATTS, \c RAWIMUS etc)
+    /// \details https://docs.novatel.com/OEM7/Content/Messages/Description_of_Short_Headers.htm
+    /// \details \ref strualign "Structure alignment"
+    /// \ingroup oem7data
+    struct ATTR_PACKED ShortHead {
+        uint8_t msgLenght;			///< The length in bytes of the body of the message, not including the header nor the CRC
+        uint16_t msgId;				///< Message ID
+        uint16_t week;				///< GPS reference week number
+        uint32_t ms;				///< Milliseconds from the beginning of the GPS reference week
+    };
     /// \struct oem7::Version oem7.h
     /// \brief \c VERSION Binary structure
     /// \details Version information
@@ -433,15 +532,82 @@ namespace oem7 {
         uint8_t gbdMask;			///< Galileo and BeiDou signals used mask
         uint8_t gpsMask;			///< GPS and GLONASS signals used mask
     };
+    /// \struct oem7::InsAttS oem7.h
+    /// \brief \c INSATTS Binary structure
+    /// \details Short INS attitude, short header log of SPAN receivers at up to the IMU rate
+    /// \details https://docs.novatel.com/OEM7/Content/SPAN_Logs/INSATTS.htm
+    /// \details \ref strualign "Structure alignment"
+    /// \ingroup oem7data
+    struct ATTR_PACKED InsAttS {
+        uint32_t week;              ///< GNSS week
+        double seconds;             ///< Seconds from week start
+        double roll;                ///< Right-handed rotation from local level around y-axis in degrees
+        double pitch;               ///< Right-handed rotation from local level around x-axis in degrees
+        double azimuth;             ///< Left-handed rotation around z-axis in degrees clockwise from North
+        uint32_t status;            ///< INS status, 3 - solution good
+    };
+    /// \struct oem7::LogCommand oem7.h
+    /// \brief \c LOG Binary command structure
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/LOG.htm
+    /// \details \ref strualign "Structure alignment"
+    /// \ingroup oem7data
+    struct ATTR_PACKED LogCommand {
+        uint32_t port;              ///< Output port (See: \b Detailed \b Port \b Identifier enumerator)
+        uint16_t msgId;             ///< Message ID of log
+        uint8_t msgType;            ///< Message type: 0 - binary
+        uint8_t reserved;           ///< Reserved
+        uint32_t trigger;           ///< Trigger (See: \b Log \b Trigger enumerator)
+        double period;              ///< Log period for \c ONTIME trigger (s)
+        double offset;              ///< Offset for period (s)
+        uint32_t hold;              ///< 1 - keep log on \c UNLOGALL
+    };
+    /// \struct oem7::UnlogAllCommand oem7.h
+    /// \brief \c UNLOGALL Binary command structure
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/UNLOGALL.htm
+    /// \details \ref strualign "Structure alignment"
+    /// \ingroup oem7data
+    struct ATTR_PACKED UnlogAllCommand {
+        uint32_t port;              ///< Port to clear (See: \b Detailed \b Port \b Identifier enumerator)
+        uint32_t held;              ///< 1 - remove held logs too
+    };
+    /// \struct oem7::StatusConfigCommand oem7.h
+    /// \brief \c STATUSCONFIG Binary command structure
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/STATUSCONFIG.htm
+    /// \details \ref strualign "Structure alignment"
+    /// \ingroup oem7data
+    struct ATTR_PACKED StatusConfigCommand {
+        uint32_t type;              ///< Mask type (See: \b STATUSCONFIG \b Mask \b Type enumerator)
+        uint32_t word;              ///< Status word (See: \b Status \b Word enumerator)
+        uint32_t mask;              ///< Mask
+    };
+    /// \struct oem7::SerialConfigCommand oem7.h
+    /// \brief \c SERIALCONFIG Binary command structure
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/SERIALCONFIG.htm
+    /// \details \ref strualign "Structure alignment"
+    /// \ingroup oem7data
+    struct ATTR_PACKED SerialConfigCommand {
+        uint32_t port;              ///< Port (See: \b Serial \b Port \b Identifier enumerator)
+        uint32_t baud;              ///< Baud rate
+        uint32_t parity;            ///< Parity: 0 - none, 1 - even, 2 - odd
+        uint32_t dataBits;          ///< Data bits
+        uint32_t stopBits;          ///< Stop bits
+        uint32_t handshake;         ///< Handshaking: 0 - none, 1 - XON/XOFF, 2 - CTS/RTS
+        uint32_t breakDetect;       ///< Break detection: 0 - off, 1 - on
+    };
+    /// \struct oem7::AntennaTypeCommand oem7.h
+    /// \brief \c ANTENNATYPE Binary command structure without frequency records
+    /// \details https://docs.novatel.com/OEM7/Content/Commands/ANTENNATYPE.htm
+    /// \details \ref strualign "Structure alignment"
+    /// \ingroup oem7data
+    struct ATTR_PACKED AntennaTypeCommand {
+        uint32_t action;            ///< Action (See: \b ANTENNATYPE \b Action enumerator)
+        uint32_t type;              ///< Antenna type (See: \b User-Defined \b Antenna \b Type enumerator)
+        char name[16];              ///< Antenna name
+        uint32_t frequencies;       ///< Number of frequency records that follow
+    };
 #ifdef WIN32
 #pragma pack(pop)
 #endif
-    extern const char* txterror[33];
-    extern const char* txtstatus[33];
-    extern const char* txtaux1[33];
-    extern const char* txtaux2[33];
-    extern const char* txtaux3[33];
-    extern const char* txtaux4[33];
 }
 
 #endif // __OEM7_H__